@@ -0,0 +1,382 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Software renderer standing in for the gint display and gray engine, so that
+src/display.c runs on Linux. It keeps the calculator's VRAM layout: 128x64,
+one bit per pixel, 32 pixels per word with the leftmost pixel in the most
+significant bit, and a light and a dark plane. Like the gray engine, it
+draws into two buffers in turn. The screen is a copy of the last buffer
+passed to dupdate().
+
+Gray levels are stored as light | dark << 1, so C_LIGHT and C_DARK each use
+one plane and C_BLACK uses both.
+*/
+
+#include <png.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gint/display.h>
+#include <gint/gray.h>
+#include <gint/hardware.h>
+
+#define ROW_WORDS (DWIDTH / 32)
+#define PLANE_WORDS (ROW_WORDS * DHEIGHT)
+#define FONT_FIRST 0x20
+#define FONT_COUNT 95
+#define FONT_GRID 5
+
+uint32_t gint[1] = {HWCALC_FX9860G_SH4};
+
+#define IMAGE(name) bopti_image_t img_##name = {#name, 0, 0, NULL};
+IMAGE(background)
+IMAGE(background_cg100)
+IMAGE(beam)
+IMAGE(cursor)
+IMAGE(selection)
+IMAGE(solved)
+IMAGE(target_hit)
+IMAGE(target_missed)
+IMAGE(tokens)
+#undef IMAGE
+
+static bopti_image_t *images[] = {
+	&img_background, &img_background_cg100, &img_beam, &img_cursor,
+	&img_selection, &img_solved, &img_target_hit, &img_target_missed,
+	&img_tokens
+};
+
+font_t font_laser = {"font_laser", 0, 0, NULL, {0}};
+
+static uint32_t vram[2][2][PLANE_WORDS];
+static uint32_t screen[2][PLANE_WORDS];
+static int vram_i;
+static bool gray;
+static font_t const *font = &font_laser;
+static struct dwindow window = {0, 0, DWIDTH, DHEIGHT};
+
+static int get_pixel(uint32_t planes[2][PLANE_WORDS], int x, int y)
+{
+	int i = ROW_WORDS * y + x / 32;
+	uint32_t bit = 0x80000000 >> (x & 31);
+	return ((planes[0][i] & bit) ? 1 : 0) | ((planes[1][i] & bit) ? 2 : 0);
+}
+
+void dpixel(int x, int y, int color)
+{
+	if (x < window.left || x >= window.right || y < window.top ||
+			y >= window.bottom || color == C_NONE)
+		return;
+	uint32_t (*planes)[PLANE_WORDS] = vram[vram_i];
+	if (color == C_INVERT)
+		color = C_BLACK - get_pixel(planes, x, y);
+	int i = ROW_WORDS * y + x / 32;
+	uint32_t bit = 0x80000000 >> (x & 31);
+	for (int plane = 0; plane < 2; ++plane) {
+		if (color & (1 << plane))
+			planes[plane][i] |= bit;
+		else
+			planes[plane][i] &= ~bit;
+	}
+}
+
+void dclear(int color)
+{
+	drect(0, 0, DWIDTH - 1, DHEIGHT - 1, color);
+}
+
+void drect(int x1, int y1, int x2, int y2, int color)
+{
+	for (int y = y1; y <= y2; ++y)
+		for (int x = x1; x <= x2; ++x)
+			dpixel(x, y, color);
+}
+
+void dline(int x1, int y1, int x2, int y2, int color)
+{
+	int dx = abs(x2 - x1);
+	int dy = -abs(y2 - y1);
+	int sx = x1 < x2 ? 1 : -1;
+	int sy = y1 < y2 ? 1 : -1;
+	int err = dx + dy;
+	while (1) {
+		dpixel(x1, y1, color);
+		if (x1 == x2 && y1 == y2)
+			break;
+		int e2 = 2 * err;
+		if (e2 >= dy) {
+			err += dy;
+			x1 += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			y1 += sy;
+		}
+	}
+}
+
+void dsubimage(int x, int y, bopti_image_t const *image, int left, int top,
+	int width, int height, int flags)
+{
+	(void)flags;
+	for (int dy = 0; dy < height && top + dy < image->height; ++dy)
+		for (int dx = 0; dx < width && left + dx < image->width; ++dx)
+			dpixel(x + dx, y + dy, image->pixels[image->width *
+				(top + dy) + left + dx]);
+}
+
+void dimage(int x, int y, bopti_image_t const *image)
+{
+	dsubimage(x, y, image, 0, 0, image->width, image->height, DIMAGE_NONE);
+}
+
+void dfont(font_t const *new_font)
+{
+	// There is no built-in font here, use the game's
+	font = new_font ? new_font : &font_laser;
+}
+
+static int text_width(char const *str, int size)
+{
+	int width = 0;
+	for (int i = 0; str[i] && (size < 0 || i < size); ++i) {
+		int c = (unsigned char)str[i] - FONT_FIRST;
+		if (c >= 0 && c < FONT_COUNT)
+			width += font->glyph_width[c] + 1;
+	}
+	return width ? width - 1 : 0;
+}
+
+void dtext_opt(int x, int y, int fg, int bg, int halign, int valign,
+	char const *str, int size)
+{
+	int width = text_width(str, size);
+	if (halign == DTEXT_RIGHT)
+		x -= width - 1;
+	else if (halign == DTEXT_CENTER)
+		x -= width / 2;
+	if (valign == DTEXT_BOTTOM)
+		y -= FONT_GRID - 1;
+	else if (valign == DTEXT_MIDDLE)
+		y -= FONT_GRID / 2;
+	if (bg != C_NONE)
+		drect(x, y, x + width - 1, y + FONT_GRID - 1, bg);
+
+	for (int i = 0; str[i] && (size < 0 || i < size); ++i) {
+		int c = (unsigned char)str[i] - FONT_FIRST;
+		if (c < 0 || c >= FONT_COUNT)
+			continue;
+		int gx = FONT_GRID * (c % (font->width / FONT_GRID));
+		int gy = FONT_GRID * (c / (font->width / FONT_GRID));
+		for (int dy = 0; dy < FONT_GRID; ++dy)
+			for (int dx = 0; dx < font->glyph_width[c]; ++dx)
+				if (font->ink[font->width * (gy + dy) + gx + dx])
+					dpixel(x + dx, y + dy, fg);
+		x += font->glyph_width[c] + 1;
+	}
+}
+
+void dtext(int x, int y, int fg, char const *str)
+{
+	dtext_opt(x, y, fg, C_NONE, DTEXT_LEFT, DTEXT_TOP, str, -1);
+}
+
+void dprint_opt(int x, int y, int fg, int bg, int halign, int valign,
+	char const *format, ...)
+{
+	char str[256];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(str, sizeof(str), format, args);
+	va_end(args);
+	dtext_opt(x, y, fg, bg, halign, valign, str, -1);
+}
+
+void dprint(int x, int y, int fg, char const *format, ...)
+{
+	char str[256];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(str, sizeof(str), format, args);
+	va_end(args);
+	dtext(x, y, fg, str);
+}
+
+struct dwindow dwindow_set(struct dwindow new_window)
+{
+	struct dwindow old = window;
+	window = new_window;
+	return old;
+}
+
+void dupdate(void)
+{
+	memcpy(screen, vram[vram_i], sizeof(screen));
+	if (gray)
+		vram_i ^= 1;
+}
+
+int dgray(int mode)
+{
+	if ((mode == DGRAY_ON) != gray)
+		vram_i = 0;
+	gray = mode == DGRAY_ON;
+	return 0;
+}
+
+bool dgray_enabled(void)
+{
+	return gray;
+}
+
+void dgray_setdelays(uint32_t light, uint32_t dark)
+{
+	(void)light;
+	(void)dark;
+}
+
+void dgray_setcolors(uint16_t black, uint16_t dark, uint16_t light,
+	uint16_t white)
+{
+	(void)black;
+	(void)dark;
+	(void)light;
+	(void)white;
+}
+
+void dgray_getvram(uint32_t **light, uint32_t **dark)
+{
+	*light = vram[vram_i][0];
+	*dark = vram[vram_i][1];
+}
+
+static uint8_t *load_png(const char *assets, const char *name, int *width,
+	int *height)
+{
+	char path[512];
+	snprintf(path, sizeof(path), "%s/%s.png", assets, name);
+	png_image png;
+	memset(&png, 0, sizeof(png));
+	png.version = PNG_IMAGE_VERSION;
+	if (!png_image_begin_read_from_file(&png, path)) {
+		fprintf(stderr, "%s: %s\n", path, png.message);
+		return NULL;
+	}
+	png.format = PNG_FORMAT_RGBA;
+	uint8_t *rgba = malloc(PNG_IMAGE_SIZE(png));
+	if (!rgba || !png_image_finish_read(&png, NULL, rgba, 0, NULL)) {
+		fprintf(stderr, "%s: %s\n", path, png.message);
+		free(rgba);
+		return NULL;
+	}
+
+	// Map to gray levels the way fxconv does: 00, 55, aa, ff
+	int size = png.width * png.height;
+	uint8_t *pixels = malloc(size);
+	for (int i = 0; pixels && i < size; ++i) {
+		uint8_t *p = &rgba[4 * i];
+		int level = (p[0] + p[1] + p[2]) / 3;
+		if (p[3] < 0x80)
+			pixels[i] = C_NONE;
+		else if (level >= 0xd5)
+			pixels[i] = C_WHITE;
+		else if (level >= 0x80)
+			pixels[i] = C_LIGHT;
+		else if (level >= 0x2b)
+			pixels[i] = C_DARK;
+		else
+			pixels[i] = C_BLACK;
+	}
+	free(rgba);
+	*width = png.width;
+	*height = png.height;
+	return pixels;
+}
+
+int dhost_load(const char *assets)
+{
+	for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); ++i) {
+		bopti_image_t *image = images[i];
+		image->pixels = load_png(assets, image->name, &image->width,
+					&image->height);
+		if (!image->pixels)
+			return 1;
+	}
+
+	// Proportional glyphs are as wide as their rightmost ink, and spaces
+	// are half of the grid
+	font_t *f = &font_laser;
+	f->ink = load_png(assets, f->name, &f->width, &f->height);
+	if (!f->ink)
+		return 1;
+	for (int i = 0; i < f->width * f->height; ++i)
+		f->ink[i] = f->ink[i] == C_BLACK;
+	for (int c = 0; c < FONT_COUNT; ++c) {
+		int gx = FONT_GRID * (c % (f->width / FONT_GRID));
+		int gy = FONT_GRID * (c / (f->width / FONT_GRID));
+		int width = FONT_GRID / 2;
+		for (int dy = 0; dy < FONT_GRID; ++dy)
+			for (int dx = 0; dx < FONT_GRID; ++dx)
+				if (f->ink[f->width * (gy + dy) + gx + dx] &&
+						dx + 1 > width)
+					width = dx + 1;
+		f->glyph_width[c] = width;
+	}
+	return 0;
+}
+
+/* FNV-1a over both planes of the screen */
+uint32_t dhost_hash(void)
+{
+	uint32_t hash = 2166136261u;
+	const uint8_t *bytes = (const uint8_t *)screen;
+	for (size_t i = 0; i < sizeof(screen); ++i)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+int dhost_save(const char *path)
+{
+	static const uint8_t levels[4] = {0xff, 0xaa, 0x55, 0x00};
+	uint8_t pixels[DWIDTH * DHEIGHT];
+	for (int y = 0; y < DHEIGHT; ++y)
+		for (int x = 0; x < DWIDTH; ++x)
+			pixels[DWIDTH * y + x] = levels[get_pixel(screen, x, y)];
+
+	size_t len = strlen(path);
+	if (len >= 4 && !strcmp(path + len - 4, ".pgm")) {
+		FILE *f = fopen(path, "wb");
+		if (!f)
+			return 1;
+		fprintf(f, "P5\n%d %d\n255\n", DWIDTH, DHEIGHT);
+		int rc = fwrite(pixels, 1, sizeof(pixels), f) != sizeof(pixels);
+		return fclose(f) || rc;
+	}
+
+	png_image png;
+	memset(&png, 0, sizeof(png));
+	png.version = PNG_IMAGE_VERSION;
+	png.width = DWIDTH;
+	png.height = DHEIGHT;
+	png.format = PNG_FORMAT_GRAY;
+	return !png_image_write_to_file(&png, path, 0, pixels, 0, NULL);
+}
@@ -0,0 +1,98 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* Host stand-in for the gint display, a software renderer, see host/display.c */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DWIDTH 128
+#define DHEIGHT 64
+
+enum {
+	C_WHITE,
+	C_LIGHT,
+	C_DARK,
+	C_BLACK,
+	C_NONE,
+	C_INVERT
+};
+
+enum {
+	DTEXT_LEFT,
+	DTEXT_CENTER,
+	DTEXT_RIGHT
+};
+
+enum {
+	DTEXT_TOP,
+	DTEXT_MIDDLE,
+	DTEXT_BOTTOM
+};
+
+#define DIMAGE_NONE 0
+
+/* Pixels are gray levels C_WHITE to C_BLACK, or C_NONE if transparent */
+typedef struct {
+	const char *name;
+	int width;
+	int height;
+	uint8_t *pixels;
+} bopti_image_t;
+
+typedef struct {
+	const char *name;
+	int width;
+	int height;
+	uint8_t *ink;
+	uint8_t glyph_width[96];
+} font_t;
+
+struct dwindow {
+	int left;
+	int top;
+	int right;
+	int bottom;
+};
+
+void dclear(int color);
+void dpixel(int x, int y, int color);
+void drect(int x1, int y1, int x2, int y2, int color);
+void dline(int x1, int y1, int x2, int y2, int color);
+void dimage(int x, int y, bopti_image_t const *image);
+void dsubimage(int x, int y, bopti_image_t const *image, int left, int top,
+	int width, int height, int flags);
+void dfont(font_t const *font);
+void dtext_opt(int x, int y, int fg, int bg, int halign, int valign,
+	char const *str, int size);
+void dtext(int x, int y, int fg, char const *str);
+void dprint_opt(int x, int y, int fg, int bg, int halign, int valign,
+	char const *format, ...);
+void dprint(int x, int y, int fg, char const *format, ...);
+struct dwindow dwindow_set(struct dwindow window);
+void dupdate(void);
+
+/* Host only: load the images and font from a directory of PNGs, save the
+screen as PGM (.pgm) or PNG (anything else), and hash it to compare frames */
+int dhost_load(const char *assets);
+int dhost_save(const char *path);
+uint32_t dhost_hash(void);
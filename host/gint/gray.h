@@ -0,0 +1,41 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* Host stand-in for the gint gray engine, see host/display.c */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <gint/display.h>
+
+#define DGRAY_OFF 0
+#define DGRAY_ON 1
+
+#define DGRAY_BLACK_DEFAULT 0x0000
+#define DGRAY_DARK_DEFAULT 0x528a
+#define DGRAY_WHITE_DEFAULT 0xffff
+
+int dgray(int mode);
+bool dgray_enabled(void);
+void dgray_setdelays(uint32_t light, uint32_t dark);
+void dgray_setcolors(uint16_t black, uint16_t dark, uint16_t light,
+	uint16_t white);
+void dgray_getvram(uint32_t **light, uint32_t **dark);
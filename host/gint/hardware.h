@@ -0,0 +1,37 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* Host stand-in for the gint hardware information, see host/display.c */
+
+#pragma once
+
+#include <stdint.h>
+
+#define HWCALC 0
+
+enum {
+	HWCALC_FX9860G_SH3,
+	HWCALC_FX9860G_SH4,
+	HWCALC_G35PE2,
+	HWCALC_FXCG50,
+	HWCALC_FXCG100
+};
+
+extern uint32_t gint[];
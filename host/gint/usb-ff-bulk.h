@@ -0,0 +1,42 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* Host stand-in for the gint fxlink interface, see host/usb.c */
+
+#pragma once
+
+#include <gint/usb.h>
+
+typedef struct {
+	uint32_t version;
+	uint32_t size;
+	uint32_t transfer_size;
+	char application[16];
+	char type[16];
+} usb_fxlink_header_t;
+
+int usb_ff_bulk_input(void);
+bool usb_fxlink_handle_messages(usb_fxlink_header_t *header);
+void usb_fxlink_drop_transaction(void);
+void usb_fxlink_text(char const *text, int size);
+
+/* Host only: where messages come from, and whether it has run dry */
+int usb_host_open(const char *path);
+bool usb_host_eof(void);
@@ -0,0 +1,384 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Microbenchmarks of the game engine in src/game.c and src/solver.c:
+	build_host/laser-bench [-o OUT.json] [-c BASELINE.json] [-t PERCENT]
+		PACK.dat
+Each benchmark is sized so that a round takes BENCH_ROUND seconds, and the
+best of BENCH_ROUNDS rounds is kept, in nanoseconds per operation. A round
+runs every benchmark once, so that a slow spell of the machine only costs
+each benchmark a round or two. The results are printed and, with -o,
+written as JSON. With -c, the run fails when a benchmark is more than
+PERCENT (default 10) slower than in BASELINE, a JSON file written by an
+earlier run, or when solving the pack takes PERCENT more traces. The trace
+count does not depend on the machine. Timings do, so while any benchmark
+looks slower, up to BENCH_ATTEMPTS runs are made, each keeping the best
+times so far.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/game.h"
+#include "../src/solver.h"
+
+#define BENCH_ROUND 0.05
+#define BENCH_ROUNDS 10
+#define BENCH_ATTEMPTS 5
+
+typedef struct {
+	const char *name;
+	double (*run)(int n);
+	double ns;
+	int n;
+	double base_ns;
+} bench_t;
+
+static int pack_size;
+static token_t stress[2][GRID_SIZE];
+static path_t beam[BEAM_MAX];
+static int solved_count;
+static uint32_t solve_traces;
+
+static int usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-o OUT.json] [-c BASELINE.json] "
+		"[-t PERCENT] PACK.dat\n", name);
+	return 2;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* load_puzzle(): next puzzle, with the snapshot check of the previous one */
+static double run_load(int n)
+{
+	double start = now();
+	for (int i = 0; i < n; ++i)
+		game_next_puzzle();
+	return now() - start;
+}
+
+/* game_laser() on every puzzle of the pack in turn */
+static double run_laser(int n)
+{
+	double time = 0;
+	int count = game_get_puzzle_count();
+	for (int p = 0; p < count; ++p) {
+		game_goto_puzzle(p);
+		int reps = n / count + (p < n % count);
+		double start = now();
+		for (int i = 0; i < reps; ++i) {
+			game_retrace();
+			game_laser();
+		}
+		time += now() - start;
+	}
+	return time;
+}
+
+/* A beam split everywhere, where add_path() checks many paths for duplicates */
+static double run_stress(token_t *grid, int n)
+{
+	trace_t trace;
+	double start = now();
+	for (int i = 0; i < n; ++i)
+		game_trace(grid, 0, beam, &trace);
+	return now() - start;
+}
+
+static double run_splitters(int n)
+{
+	return run_stress(stress[0], n);
+}
+
+static double run_checker(int n)
+{
+	return run_stress(stress[1], n);
+}
+
+/* find_unsolved_puzzle() from game_init(), with only the last one left */
+static double run_init(int n)
+{
+	char *solved = game_get_solved();
+	memset(solved, '1', PUZZLE_MAX);
+	solved[game_get_puzzle_count() - 1] = '0';
+	double start = now();
+	for (int i = 0; i < n; ++i)
+		game_init(pack_size, 0);
+	double time = now() - start;
+	memset(solved, '0', PUZZLE_MAX);
+	return time;
+}
+
+/* Solves every puzzle of the pack, n times */
+static double run_solve(int n)
+{
+	double start = now();
+	for (int i = 0; i < n; ++i) {
+		solved_count = 0;
+		solve_traces = 0;
+		for (int p = 0; p < game_get_puzzle_count(); ++p) {
+			token_t grid[GRID_SIZE];
+			int targets = game_get_layout(p, grid);
+			solver_start(grid, targets);
+			while (solver_step(4096) == SOLVER_BUSY)
+				;
+			solved_count += solver_status() == SOLVER_SOLVED;
+			solve_traces += solver_traces();
+		}
+	}
+	return now() - start;
+}
+
+static bench_t benches[] = {
+	{"load", run_load, 0, 0, 0},
+	{"laser", run_laser, 0, 0, 0},
+	{"laser_splitters", run_splitters, 0, 0, 0},
+	{"laser_checker", run_checker, 0, 0, 0},
+	{"init_unsolved", run_init, 0, 0, 0},
+	{"solve_pack", run_solve, 0, 0, 0},
+};
+
+#define BENCH_COUNT (int)(sizeof(benches) / sizeof(benches[0]))
+
+/*
+A laser in the corner of a board of splitters, which fills the beam with
+BEAM_MAX paths, and of a checkerboard of splitters and mirrors (34 paths)
+*/
+static void build_stress(void)
+{
+	for (int b = 0; b < 2; ++b)
+		for (int cell = 0; cell < GRID_SIZE; ++cell) {
+			token_t *token = &stress[b][cell];
+			memset(token, 0, sizeof(*token));
+			int row = cell / GRID_WIDTH;
+			int col = cell % GRID_WIDTH;
+			token->type = (b && (row + col) % 2) ? TOKEN_MIRROR :
+				TOKEN_SPLITTER;
+			if (b)
+				token->dir = row % 2 ? DIR_EAST : DIR_NORTH;
+			else
+				token->dir = (row + col) % 4 < 2 ? DIR_NORTH :
+					DIR_EAST;
+		}
+	for (int b = 0; b < 2; ++b) {
+		stress[b][0].type = TOKEN_LASER;
+		stress[b][0].dir = DIR_EAST;
+	}
+}
+
+/* Runs BENCH_ROUNDS rounds, keeping the best time of each benchmark so far */
+static void measure(void)
+{
+	double best[BENCH_COUNT];
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		bench_t *bench = &benches[i];
+		if (!bench->n) {
+			bench->n = 1;
+			while (bench->run(bench->n) < BENCH_ROUND &&
+					bench->n < (1 << 30))
+				bench->n *= 2;
+		}
+		best[i] = bench->ns ? bench->ns * bench->n / 1e9 :
+			bench->run(bench->n);
+	}
+	for (int round = 1; round < BENCH_ROUNDS; ++round)
+		for (int i = 0; i < BENCH_COUNT; ++i) {
+			double time = benches[i].run(benches[i].n);
+			if (time < best[i])
+				best[i] = time;
+		}
+	for (int i = 0; i < BENCH_COUNT; ++i)
+		benches[i].ns = best[i] * 1e9 / benches[i].n;
+}
+
+/* Change from the baseline in percent, or 0 without one */
+static double change(double value, double base)
+{
+	return base > 0 ? 100 * (value - base) / base : 0;
+}
+
+static int timing_regressed(double threshold)
+{
+	for (int i = 0; i < BENCH_COUNT; ++i)
+		if (change(benches[i].ns, benches[i].base_ns) > threshold)
+			return 1;
+	return 0;
+}
+
+/* Writes a JSON string, escaping quotes, backslashes and control characters */
+static void write_string(FILE *f, const char *str)
+{
+	fputc('"', f);
+	for (; *str; ++str) {
+		unsigned char c = *str;
+		if (c == '"' || c == '\\')
+			fprintf(f, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(f, "\\u%04x", c);
+		else
+			fputc(c, f);
+	}
+	fputc('"', f);
+}
+
+static int write_json(const char *path, const char *pack)
+{
+	FILE *f = fopen(path, "w");
+	if (!f) {
+		perror(path);
+		return 1;
+	}
+	fprintf(f, "{\n  \"pack\": ");
+	write_string(f, pack);
+	fprintf(f, ",\n  \"puzzles\": %i,\n"
+		"  \"solved\": %i,\n  \"solve_traces\": %lu,\n"
+		"  \"benchmarks\": {\n", game_get_puzzle_count(),
+		solved_count, (unsigned long)solve_traces);
+	for (int i = 0; i < BENCH_COUNT; ++i)
+		fprintf(f, "    \"%s\": {\"ns\": %.1f, \"n\": %i}%s\n",
+			benches[i].name, benches[i].ns, benches[i].n,
+			i < BENCH_COUNT - 1 ? "," : "");
+	fprintf(f, "  }\n}\n");
+	fclose(f);
+	return 0;
+}
+
+/* Trace count of the pack solve in a file written by write_json(), or 0 */
+static unsigned long baseline_traces(FILE *f)
+{
+	char line[256];
+	rewind(f);
+	while (fgets(line, sizeof(line), f)) {
+		unsigned long traces;
+		if (sscanf(line, " \"solve_traces\": %lu", &traces) == 1)
+			return traces;
+	}
+	return 0;
+}
+
+/* Time of a benchmark in a file written by write_json(), or 0 */
+static double baseline_ns(FILE *f, const char *name)
+{
+	char line[256];
+	rewind(f);
+	while (fgets(line, sizeof(line), f)) {
+		char key[64];
+		double ns;
+		if (sscanf(line, " \"%63[^\"]\": {\"ns\": %lf", key, &ns) == 2 &&
+				!strcmp(key, name))
+			return ns;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *out = NULL;
+	const char *baseline = NULL;
+	double threshold = 10;
+	int opt;
+	while ((opt = getopt(argc, argv, "o:c:t:")) != -1) {
+		switch (opt) {
+		case 'o':
+			out = optarg;
+			break;
+		case 'c':
+			baseline = optarg;
+			break;
+		case 't':
+			threshold = atof(optarg);
+			break;
+		default:
+			return usage(argv[0]);
+		}
+	}
+	if (optind != argc - 1)
+		return usage(argv[0]);
+
+	const char *pack = argv[optind];
+	FILE *f = fopen(pack, "rb");
+	if (!f) {
+		perror(pack);
+		return 1;
+	}
+	pack_size = fread(game_get_puzzles(), 1, PUZZLE_BYTES, f);
+	fclose(f);
+	memset(game_get_snapshots(), 0xff, SNAPSHOT_BYTES);
+	if (game_init(pack_size, 1)) {
+		fprintf(stderr, "%s: bad pack\n", pack);
+		return 1;
+	}
+	build_stress();
+
+	unsigned long base_traces = 0;
+	if (baseline) {
+		FILE *base = fopen(baseline, "r");
+		if (!base) {
+			perror(baseline);
+			return 1;
+		}
+		for (int i = 0; i < BENCH_COUNT; ++i)
+			benches[i].base_ns = baseline_ns(base, benches[i].name);
+		base_traces = baseline_traces(base);
+		fclose(base);
+	}
+	measure();
+	for (int i = 1; i < BENCH_ATTEMPTS && timing_regressed(threshold);
+			++i) {
+		fprintf(stderr, "%s: slower than the baseline, measuring "
+			"again\n", argv[0]);
+		measure();
+	}
+
+	int failed = 0;
+	for (int i = 0; i < BENCH_COUNT; ++i) {
+		bench_t *bench = &benches[i];
+		printf("%-16s %12.1f ns", bench->name, bench->ns);
+		if (bench->base_ns > 0) {
+			double percent = change(bench->ns, bench->base_ns);
+			int slower = percent > threshold;
+			printf("  %+7.1f%%%s", percent,
+				slower ? "  REGRESSION" : "");
+			failed |= slower;
+		}
+		printf("\n");
+	}
+	printf("solved %i/%i puzzles, %lu traces", solved_count,
+		game_get_puzzle_count(), (unsigned long)solve_traces);
+	if (base_traces) {
+		double percent = change(solve_traces, base_traces);
+		int more = percent > threshold;
+		printf("  %+.1f%%%s", percent, more ? "  REGRESSION" : "");
+		failed |= more;
+	}
+	printf("\n");
+	if (out && write_json(out, pack))
+		return 1;
+	return failed;
+}
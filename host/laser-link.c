@@ -0,0 +1,95 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Runs the add-in's USB pack loading against host/usb.c, so that a pushed pack
+goes through the same checks and reload as on the calculator:
+	build_host/laser-link [-i INPUT] [PACK.dat]
+INPUT defaults to stdin. After each pack, the reloaded puzzle is traced and
+summarized on stdout.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <gint/usb-ff-bulk.h>
+#include "../src/game.h"
+#include "../src/link.h"
+
+static void summary(void)
+{
+	game_laser();
+	printf("puzzles %i, puzzle id %i, targets %i/%i, beam %i\n",
+		game_get_puzzle_count(), game_get_puzzle_id(),
+		get_targets_hit(), get_targets_req(), game_get_path_count());
+}
+
+int main(int argc, char **argv)
+{
+	const char *input = "-";
+	int opt;
+	while ((opt = getopt(argc, argv, "i:")) != -1) {
+		if (opt != 'i') {
+			fprintf(stderr, "usage: %s [-i INPUT] [PACK.dat]\n",
+				argv[0]);
+			return 2;
+		}
+		input = optarg;
+	}
+
+	// Start from a pack in "storage memory", like the add-in would
+	if (optind < argc) {
+		FILE *f = fopen(argv[optind], "rb");
+		if (!f) {
+			perror(argv[optind]);
+			return 1;
+		}
+		int size = fread(game_get_puzzles(), 1, PUZZLE_BYTES, f);
+		fclose(f);
+		if (size < BYTES_PER_PUZZLE) {
+			fprintf(stderr, "%s: no puzzles\n", argv[optind]);
+			return 1;
+		}
+		memset(game_get_snapshots(), 0xff, SNAPSHOT_BYTES);
+		if (game_init(size, 1)) {
+			fprintf(stderr, "%s: bad pack\n", argv[optind]);
+			return 1;
+		}
+		summary();
+	}
+
+	if (usb_host_open(input)) {
+		perror(input);
+		return 1;
+	}
+	while (!usb_host_eof()) {
+		if (!link_poll())
+			continue;
+		char *pack;
+		int size = link_take(&pack);
+		if (game_load_pack(pack, size)) {
+			link_reply("laser: pack rejected\n");
+		} else {
+			link_reply("laser: pack loaded\n");
+			summary();
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,294 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Renders puzzles with src/display.c and the software display in
+host/display.c:
+	build_host/laser-render [-a ASSETS] [-o DIR] [-b PASSES] [-c STEPS]
+		PACK.dat
+With -o, the first frame of every puzzle is saved as DIR/puzzle-NNN.png.
+With -b, display_game() is timed over all puzzles of the pack, first for a
+puzzle change (a full redraw) and then for a cursor move.
+With -c, the pack is played for STEPS random moves, picks, drops, rotations,
+undos and puzzle changes, twice over. The first time, every frame is drawn
+incrementally, and whenever a token is held, game_is_preview() is compared
+with a full game_trace() of every drop. The second time, every frame is a
+full redraw, which must match the incremental one. Exits with 1 on a
+mismatch.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <gint/display.h>
+#include "../src/display.h"
+#include "../src/game.h"
+#include "../src/library.h"
+
+// display_packs() is not rendered here
+int library_count(void)
+{
+	return 0;
+}
+
+pack_t *library_get(int i)
+{
+	(void)i;
+	return NULL;
+}
+
+static int pack_size;
+
+static int usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-a ASSETS] [-o DIR] [-b PASSES] "
+		"[-c STEPS] PACK.dat\n", name);
+	return 2;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int save_all(const char *dir)
+{
+	for (int i = 0; i < game_get_puzzle_count(); ++i) {
+		game_laser();
+		display_game();
+		char path[512];
+		snprintf(path, sizeof(path), "%s/puzzle-%03i.png", dir,
+			game_get_puzzle_id());
+		if (dhost_save(path)) {
+			perror(path);
+			return 1;
+		}
+		game_next_puzzle();
+	}
+	return 0;
+}
+
+static void bench(int passes)
+{
+	double puzzle_time = 0;
+	double cursor_time = 0;
+	int frames = 0;
+	for (int pass = 0; pass < passes; ++pass)
+		for (int i = 0; i < game_get_puzzle_count(); ++i) {
+			game_laser();
+			double start = now();
+			display_game();
+			puzzle_time += now() - start;
+
+			game_cursor_col(1);
+			start = now();
+			display_game();
+			cursor_time += now() - start;
+
+			++frames;
+			game_next_puzzle();
+		}
+	printf("frames %i, puzzle change %.2f us, cursor move %.2f us\n",
+		frames, 1e6 * puzzle_time / frames, 1e6 * cursor_time / frames);
+}
+
+/* Starts the pack over, with the cursor and view in the top left corner */
+static void restart(void)
+{
+	memset(game_get_snapshots(), 0xff, SNAPSHOT_BYTES);
+	game_init(pack_size, 1);
+	while (game_get_cursor_row() > 0)
+		game_cursor_row(-1);
+	while (game_get_cursor_col() > 0)
+		game_cursor_col(-1);
+	game_laser();
+	display_invalidate();
+	display_game();
+}
+
+static void random_step(void)
+{
+	switch (rand() % 10) {
+	case 0:
+		game_cursor_row(1);
+		break;
+	case 1:
+		game_cursor_row(-1);
+		break;
+	case 2:
+		game_cursor_col(1);
+		break;
+	case 3:
+		game_cursor_col(-1);
+		break;
+	case 4:
+	case 5:
+		game_select_token();
+		break;
+	case 6:
+		game_rotate_token(rand() % 2 ? 1 : -1);
+		break;
+	case 7:
+		game_undo();
+		break;
+	case 8:
+		game_deselect_token();
+		break;
+	default:
+		if (!(rand() % 8))
+			game_next_puzzle();
+		break;
+	}
+	game_laser();
+}
+
+/* Compares the drop preview with a full trace of each drop of the held token */
+static int check_preview(int step, int *drops)
+{
+	token_t grid[GRID_SIZE];
+	int held = -1;
+	int extra = get_targets_req();
+	for (int i = 0; i < GRID_SIZE; ++i) {
+		int row = i / GRID_WIDTH;
+		int col = i % GRID_WIDTH;
+		grid[i] = *game_get_token(row, col);
+		if (game_is_selection(row, col))
+			held = i;
+		if (grid[i].type == TOKEN_TARGET && grid[i].req_target)
+			--extra;
+	}
+	if (held < 0)
+		return 0;
+
+	token_t drop[GRID_SIZE];
+	path_t beam[BEAM_MAX];
+	trace_t now;
+	memcpy(drop, grid, sizeof(drop));
+	int lit = game_trace(drop, extra, beam, &now);
+	int bad = 0;
+	for (int cell = 0; cell < GRID_SIZE; ++cell) {
+		int better = 0;
+		if (lit && grid[cell].type == TOKEN_NONE) {
+			trace_t trace;
+			memcpy(drop, grid, sizeof(drop));
+			drop[cell] = grid[held];
+			drop[held].type = TOKEN_NONE;
+			game_trace(drop, extra, beam, &trace);
+			++*drops;
+			better = trace.targets_hit > now.targets_hit ||
+				trace.tokens_hit > now.tokens_hit;
+		}
+		if (game_is_preview(cell / GRID_WIDTH, cell % GRID_WIDTH) !=
+				better) {
+			fprintf(stderr, "step %i: puzzle %i, preview of cell "
+				"%i is wrong\n", step, game_get_puzzle_id(),
+				cell);
+			++bad;
+		}
+	}
+	return bad;
+}
+
+static int check(int steps)
+{
+	uint32_t *frames = malloc(steps * sizeof(uint32_t));
+	if (!frames)
+		return 1;
+	int bad = 0;
+	int drops = 0;
+	for (int pass = 0; pass < 2; ++pass) {
+		restart();
+		srand(1);
+		for (int step = 0; step < steps; ++step) {
+			random_step();
+			if (pass)
+				display_invalidate();
+			display_game();
+			if (!pass) {
+				frames[step] = dhost_hash();
+				bad += check_preview(step, &drops);
+			} else if (dhost_hash() != frames[step]) {
+				fprintf(stderr, "step %i: incremental frame "
+					"differs from a full redraw\n", step);
+				++bad;
+			}
+		}
+	}
+	free(frames);
+	printf("%i steps, %i drops, %i mismatches\n", steps, drops, bad);
+	return bad != 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *assets = "assets";
+	const char *output = NULL;
+	int passes = 0;
+	int steps = 0;
+	int opt;
+	while ((opt = getopt(argc, argv, "a:o:b:c:")) != -1) {
+		switch (opt) {
+		case 'a':
+			assets = optarg;
+			break;
+		case 'o':
+			output = optarg;
+			break;
+		case 'b':
+			passes = atoi(optarg);
+			break;
+		case 'c':
+			steps = atoi(optarg);
+			break;
+		default:
+			return usage(argv[0]);
+		}
+	}
+	if (optind != argc - 1)
+		return usage(argv[0]);
+
+	FILE *f = fopen(argv[optind], "rb");
+	if (!f) {
+		perror(argv[optind]);
+		return 1;
+	}
+	pack_size = fread(game_get_puzzles(), 1, PUZZLE_BYTES, f);
+	fclose(f);
+	memset(game_get_snapshots(), 0xff, SNAPSHOT_BYTES);
+	if (pack_size < BYTES_PER_PUZZLE || game_init(pack_size, 0)) {
+		fprintf(stderr, "%s: bad pack\n", argv[optind]);
+		return 1;
+	}
+	if (dhost_load(assets))
+		return 1;
+	display_init();
+
+	if (output && save_all(output))
+		return 1;
+	if (passes)
+		bench(passes);
+	if (steps)
+		return check(steps);
+	return 0;
+}
@@ -0,0 +1,297 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Replays play sessions recorded on the calculator (see src/record.c) against
+src/game.c:
+	build_host/laser-replay [-v] [-b PASSES] PACK.dat LOG.rec...
+Every checkpoint in a log is compared with the replayed state, and any
+difference fails the replay. With -v, every checkpoint is printed. With -b,
+the logs are then replayed PASSES times to time the engine.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/game.h"
+#include "../src/kbd.h"
+#include "../src/record.h"
+
+typedef struct {
+	const char *name;
+	uint8_t *data;
+	int size;
+} session_t;
+
+typedef struct {
+	int commands;
+	int traces;
+	int checks;
+	double trace_time;
+} stats_t;
+
+static int pack_size;
+static int verbose;
+
+static int usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-v] [-b PASSES] PACK.dat LOG.rec...\n",
+		name);
+	return 2;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint8_t *read_file(const char *path, int max, int *size)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f) {
+		perror(path);
+		return NULL;
+	}
+	uint8_t *data = malloc(max);
+	*size = fread(data, 1, max, f);
+	fclose(f);
+	return data;
+}
+
+/* The game part of game_command() in src/main.c */
+static void apply(command_t command)
+{
+	switch (command) {
+	case COMMAND_CURSOR_UP:
+		game_cursor_row(-1);
+		break;
+	case COMMAND_CURSOR_DOWN:
+		game_cursor_row(1);
+		break;
+	case COMMAND_CURSOR_LEFT:
+		game_cursor_col(-1);
+		break;
+	case COMMAND_CURSOR_RIGHT:
+		game_cursor_col(1);
+		break;
+	case COMMAND_SELECT:
+		game_select_token();
+		break;
+	case COMMAND_CANCEL:
+		game_deselect_token();
+		break;
+	case COMMAND_ROTATE_CCW:
+		game_rotate_token(-1);
+		break;
+	case COMMAND_ROTATE_CW:
+		game_rotate_token(1);
+		break;
+	case COMMAND_UNDO:
+		game_undo();
+		break;
+	case COMMAND_REDO:
+		game_redo();
+		break;
+	case COMMAND_PUZZLE_NEXT:
+		game_next_puzzle();
+		break;
+	case COMMAND_PUZZLE_PREV:
+		game_previous_puzzle();
+		break;
+	default:
+		// Only changes what is shown
+		break;
+	}
+}
+
+static void trace(stats_t *stats)
+{
+	double start = now();
+	game_laser();
+	stats->trace_time += now() - start;
+	++stats->traces;
+}
+
+/* Loads the pack state saved at the start of a session */
+static int start(const session_t *session)
+{
+	const uint8_t *data = session->data;
+	if (session->size < RECORD_HEAD_BYTES ||
+			memcmp(data, RECORD_MAGIC, 4)) {
+		fprintf(stderr, "%s: not a recorded session\n", session->name);
+		return 1;
+	}
+	int snapshot_bytes = data[6] | (data[7] << 8);
+	if (snapshot_bytes > SNAPSHOT_BYTES ||
+			RECORD_HEAD_BYTES + snapshot_bytes > session->size) {
+		fprintf(stderr, "%s: bad snapshots\n", session->name);
+		return 1;
+	}
+	memcpy(game_get_solved(), data + 8, PUZZLE_MAX);
+	memset(game_get_snapshots(), 0xff, SNAPSHOT_BYTES);
+	memcpy(game_get_snapshots(), data + RECORD_HEAD_BYTES, snapshot_bytes);
+	if (game_init(pack_size, 0) || game_get_puzzle_count() != data[5] ||
+			data[4] >= data[5]) {
+		fprintf(stderr, "%s: recorded with another pack\n",
+			session->name);
+		return 1;
+	}
+	game_goto_puzzle(data[4]);
+	return 0;
+}
+
+static int check(const session_t *session, const uint8_t *entry)
+{
+	record_check_t now;
+	record_state(&now);
+	record_check_t want = {entry[1], entry[2], entry[3], entry[4],
+		entry[5] | (entry[6] << 8)};
+	int ok = !memcmp(&now, &want, sizeof(now));
+	if (verbose || !ok)
+		printf("%s: %s at byte %i: puzzle %i, targets %i, solved %i, "
+			"paths %i, hash %04x", session->name,
+			ok ? "check" : "MISMATCH",
+			(int)(entry - session->data), want.puzzle,
+			want.targets_hit, want.solved, want.path_count,
+			want.beam_hash);
+	if (!ok)
+		printf(" (replayed puzzle %i, targets %i, solved %i, paths %i, "
+			"hash %04x)", now.puzzle, now.targets_hit, now.solved,
+			now.path_count, now.beam_hash);
+	if (verbose || !ok)
+		printf("\n");
+	return !ok;
+}
+
+static int replay(const session_t *session, stats_t *stats)
+{
+	if (start(session))
+		return 1;
+	trace(stats);
+
+	const uint8_t *data = session->data;
+	int pos = RECORD_HEAD_BYTES + (data[6] | (data[7] << 8));
+	while (pos < session->size) {
+		const uint8_t *entry = data + pos;
+		int size = record_entry_size(entry);
+		if (pos + size > session->size) {
+			fprintf(stderr, "%s: truncated at byte %i\n",
+				session->name, pos);
+			return 1;
+		}
+		switch (*entry & RECORD_KIND) {
+		case RECORD_COMMAND:
+			apply(*entry & RECORD_DATA);
+			++stats->commands;
+			break;
+		case RECORD_GOTO:
+			game_goto_puzzle(entry[1]);
+			++stats->commands;
+			break;
+		case RECORD_CHECK:
+			if (check(session, entry))
+				return 1;
+			++stats->checks;
+			break;
+		default:
+			break;
+		}
+		if (*entry & RECORD_TRACE)
+			trace(stats);
+		pos += size;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int passes = 0;
+	int opt;
+	while ((opt = getopt(argc, argv, "vb:")) != -1) {
+		switch (opt) {
+		case 'v':
+			verbose = 1;
+			break;
+		case 'b':
+			passes = atoi(optarg);
+			break;
+		default:
+			return usage(argv[0]);
+		}
+	}
+	if (argc - optind < 2)
+		return usage(argv[0]);
+
+	FILE *f = fopen(argv[optind], "rb");
+	if (!f) {
+		perror(argv[optind]);
+		return 1;
+	}
+	pack_size = fread(game_get_puzzles(), 1, PUZZLE_BYTES, f);
+	fclose(f);
+	if (pack_size < BYTES_PER_PUZZLE) {
+		fprintf(stderr, "%s: bad pack\n", argv[optind]);
+		return 1;
+	}
+
+	int count = argc - optind - 1;
+	session_t *sessions = calloc(count, sizeof(session_t));
+	for (int i = 0; i < count; ++i) {
+		session_t *session = &sessions[i];
+		session->name = argv[optind + 1 + i];
+		session->data = read_file(session->name, RECORD_BYTES,
+			&session->size);
+		if (!session->data)
+			return 1;
+	}
+
+	// Check every session once
+	int failed = 0;
+	for (int i = 0; i < count; ++i) {
+		stats_t stats = {0};
+		if (replay(&sessions[i], &stats)) {
+			failed = 1;
+			continue;
+		}
+		printf("%s: %i commands, %i traces, %i checks passed\n",
+			sessions[i].name, stats.commands, stats.traces,
+			stats.checks);
+	}
+	if (failed)
+		return 1;
+
+	if (passes) {
+		stats_t stats = {0};
+		double start = now();
+		for (int pass = 0; pass < passes; ++pass)
+			for (int i = 0; i < count; ++i)
+				replay(&sessions[i], &stats);
+		double total = now() - start;
+		printf("passes %i, %i commands, %.3f us per command, "
+			"%.3f us per trace\n", passes, stats.commands,
+			1e6 * total / stats.commands,
+			1e6 * stats.trace_time / stats.traces);
+	}
+	return 0;
+}
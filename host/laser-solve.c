@@ -0,0 +1,594 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Validates a pack by solving every puzzle with a portfolio of strategies:
+	build_host/laser-solve [-s STRATEGY]... PACK.dat
+	build_host/laser-solve -c BOARDS
+The strategies race on their own threads, and the first one to find a
+solution or to prove that there is none wins. The others see the done flag
+at their next check and give up. Each puzzle is printed with its result,
+winner and wall time, then the wins of each strategy and the worst time.
+With -s, only the named strategies run, to compare them. Exits with 1 if a
+puzzle has no solution. Wall times only reflect the race with a core for each
+strategy.
+	beam	src/solver.c, which places tokens only on the beam
+	brute	every movable token on every free cell, in every direction
+	best	as beam, trying first the choices whose beam hits the most
+With -c, no pack is read. Instead, beam is checked against brute on BOARDS
+random boards of up to 9 tokens, of which up to 3 move or rotate: both must
+agree on whether each board can be solved, and a solution of beam must
+solve it. Exits with 1 on a mismatch.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/game.h"
+#include "../src/solver.h"
+
+// Traces between looks at the done flag
+#define CHECK_TRACES 256
+#define SOLVER_STEPS 256
+#define CHILD_MAX (GRID_SIZE * TOKEN_COUNT * 4)
+#define CHECK_TOKENS 9
+#define CHECK_FREE 3
+
+typedef enum {
+	RESULT_NONE,
+	RESULT_SOLVED,
+	RESULT_UNSOLVABLE
+} result_t;
+
+typedef struct {
+	token_t layout[GRID_SIZE];
+	token_t grid[GRID_SIZE];
+	int targets_req;
+	int targets_extra;
+	token_t pieces[TOKEN_COUNT];
+	uint8_t cells[TOKEN_COUNT];
+	uint8_t placed[TOKEN_COUNT];
+	uint32_t kept[TOKEN_COUNT + 1];
+	int piece_count;
+	uint8_t rotors[TOKEN_COUNT];
+	int rotor_count;
+	path_t beam[BEAM_MAX];
+	uint32_t traces;
+	int cancelled;
+} search_t;
+
+typedef struct {
+	const char *name;
+	int (*solve)(search_t *search);
+	int enabled;
+	int wins;
+} strategy_t;
+
+typedef struct {
+	int index;
+	search_t search;
+	result_t result;
+	pthread_t thread;
+} runner_t;
+
+// A choice of best(): an index into its cells, a piece and a direction
+typedef struct {
+	uint8_t cell;
+	uint8_t piece;
+	uint8_t dir;
+	int score;
+} child_t;
+
+static int solve_beam(search_t *s);
+static int solve_brute(search_t *s);
+static int solve_best(search_t *s);
+
+static strategy_t strategies[] = {
+	{"beam", solve_beam, 1, 0},
+	{"brute", solve_brute, 1, 0},
+	{"best", solve_best, 1, 0},
+};
+
+#define STRATEGY_COUNT (int)(sizeof(strategies) / sizeof(strategies[0]))
+
+static runner_t runners[STRATEGY_COUNT];
+
+// The winning strategy plus 1, or 0 while they race
+static atomic_int done;
+
+static int usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-s beam|brute|best]... PACK.dat\n"
+		"       %s -c BOARDS\n", name, name);
+	return 2;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cancelled(void)
+{
+	return atomic_load_explicit(&done, memory_order_relaxed) != 0;
+}
+
+/* Traces the beam, and gives up now and then if another strategy won */
+static int trace_grid(search_t *s, trace_t *trace)
+{
+	if (!(++s->traces % CHECK_TRACES) && cancelled())
+		s->cancelled = 1;
+	return game_trace(s->grid, s->targets_extra, s->beam, trace);
+}
+
+static int trace_solves(search_t *s)
+{
+	trace_t trace;
+	return trace_grid(s, &trace) &&
+		game_trace_solves(&trace, s->targets_req);
+}
+
+/*
+Takes the movable tokens off the grid, a movable laser first. Movable blocks
+do not stop the beam, so they are left out.
+*/
+static void prepare(search_t *s, const token_t layout[GRID_SIZE], int targets)
+{
+	memset(s, 0, sizeof(*s));
+	memcpy(s->layout, layout, sizeof(s->layout));
+	memcpy(s->grid, layout, sizeof(s->grid));
+	s->targets_req = targets;
+	int req = 0;
+	for (int cell = 0; cell < GRID_SIZE; ++cell) {
+		token_t *token = &s->grid[cell];
+		if (token->type == TOKEN_TARGET && token->req_target)
+			++req;
+		if (token->type == TOKEN_NONE)
+			continue;
+		if (token->can_move) {
+			if (token->type == TOKEN_LASER) {
+				memmove(&s->pieces[1], &s->pieces[0],
+					s->piece_count * sizeof(token_t));
+				s->pieces[0] = *token;
+				++s->piece_count;
+			} else if (token->type != TOKEN_BLOCK) {
+				s->pieces[s->piece_count++] = *token;
+			}
+			token->type = TOKEN_NONE;
+		} else if (token->can_rotate && solver_dir_count(token) > 1) {
+			s->rotors[s->rotor_count++] = cell;
+		}
+	}
+	s->targets_extra = targets - req;
+}
+
+/* Identical pieces go on cells in increasing order, so layouts are seen once */
+static int first_cell(const search_t *s, int i)
+{
+	for (int k = i - 1; k >= 0; --k)
+		if (solver_same_piece(&s->pieces[k], &s->pieces[i]))
+			return s->cells[k] + 1;
+	return 0;
+}
+
+static void place(search_t *s, int i, int cell, int dir)
+{
+	s->grid[cell] = s->pieces[i];
+	if (s->pieces[i].can_rotate)
+		s->grid[cell].dir = dir;
+	s->cells[i] = cell;
+}
+
+/* Turns the rotor at depth every way, then goes on with search */
+static int turn_rotor(search_t *s, int depth, int (*search)(search_t *, int))
+{
+	token_t *token = &s->grid[s->rotors[depth]];
+	for (int dir = 0; dir < solver_dir_count(token) && !s->cancelled;
+			++dir) {
+		token->dir = dir;
+		if (search(s, depth + 1))
+			return 1;
+	}
+	return 0;
+}
+
+static int solve_beam(search_t *s)
+{
+	solver_start(s->layout, s->targets_req);
+	while (solver_step(SOLVER_STEPS) == SOLVER_BUSY)
+		if (cancelled()) {
+			s->cancelled = 1;
+			break;
+		}
+	s->traces = solver_traces();
+	if (solver_status() != SOLVER_SOLVED)
+		return 0;
+	solver_solution(s->grid);
+	return 1;
+}
+
+static int brute(search_t *s, int depth)
+{
+	if (depth < s->rotor_count)
+		return turn_rotor(s, depth, brute);
+	int i = depth - s->rotor_count;
+	if (i == s->piece_count)
+		return trace_solves(s);
+
+	for (int cell = first_cell(s, i); cell < GRID_SIZE; ++cell) {
+		if (s->grid[cell].type != TOKEN_NONE)
+			continue;
+		for (int dir = 0; dir < solver_dir_count(&s->pieces[i]);
+				++dir) {
+			place(s, i, cell, dir);
+			if (brute(s, depth + 1))
+				return 1;
+			if (s->cancelled)
+				return 0;
+		}
+		s->grid[cell].type = TOKEN_NONE;
+	}
+	return 0;
+}
+
+static int solve_brute(search_t *s)
+{
+	return brute(s, 0);
+}
+
+static int compare_children(const void *a, const void *b)
+{
+	return ((const child_t *)b)->score - ((const child_t *)a)->score;
+}
+
+/*
+Places the pieces as src/solver.c does, any of them on an empty cell of the
+beam, keeping the cells the beam crossed before it empty. The choices of a
+node are scored by the targets and tokens their beam hits, and the best are
+tried first. A choice for the last piece that solves the puzzle ends the
+search at once.
+*/
+static int best(search_t *s, int depth)
+{
+	if (depth < s->rotor_count)
+		return turn_rotor(s, depth, best);
+	int i = depth - s->rotor_count;
+	if (i == s->piece_count)
+		return trace_solves(s);
+
+	// Empty cells of the beam in order, or anywhere for the laser
+	uint8_t cells[GRID_SIZE];
+	int cell_count = 0;
+	uint32_t kept = s->kept[i];
+	trace_t trace;
+	int laser = !trace_grid(s, &trace);
+	if (laser) {
+		for (int cell = 0; cell < GRID_SIZE; ++cell)
+			if (s->grid[cell].type == TOKEN_NONE)
+				cells[cell_count++] = cell;
+	} else {
+		uint32_t seen = kept;
+		for (int p = 0; p < trace.path_count; ++p) {
+			int cell = GRID_WIDTH * s->beam[p].row +
+				s->beam[p].col;
+			if (s->grid[cell].type != TOKEN_NONE ||
+					(seen & (1UL << cell)))
+				continue;
+			seen |= 1UL << cell;
+			cells[cell_count++] = cell;
+		}
+	}
+
+	child_t children[CHILD_MAX];
+	int count = 0;
+	int last = i == s->piece_count - 1;
+	for (int c = 0; c < cell_count; ++c)
+		for (int p = 0; p < s->piece_count; ++p) {
+			token_t *piece = &s->pieces[p];
+			if (s->placed[p] ||
+					laser != (piece->type == TOKEN_LASER))
+				continue;
+			int twin = 0;
+			for (int k = 0; k < p && !twin; ++k)
+				twin = !s->placed[k] &&
+					solver_same_piece(&s->pieces[k], piece);
+			if (twin)
+				continue;
+			for (int dir = 0; dir < solver_dir_count(piece);
+					++dir) {
+				place(s, p, cells[c], dir);
+				int score = 0;
+				if (trace_grid(s, &trace)) {
+					if (last && game_trace_solves(&trace,
+							s->targets_req))
+						return 1;
+					score = (TOKEN_COUNT + 1) *
+						trace.targets_hit +
+						trace.tokens_hit;
+				}
+				s->grid[cells[c]].type = TOKEN_NONE;
+				children[count++] = (child_t){c, p, dir, score};
+			}
+		}
+	if (last)
+		return 0;
+
+	qsort(children, count, sizeof(child_t), compare_children);
+	for (int c = 0; c < count && !s->cancelled; ++c) {
+		child_t *child = &children[c];
+		int cell = cells[child->cell];
+		place(s, child->piece, cell, child->dir);
+		s->placed[child->piece] = 1;
+		s->kept[i + 1] = kept;
+		for (int k = 0; k < child->cell && !laser; ++k)
+			s->kept[i + 1] |= 1UL << cells[k];
+		if (best(s, depth + 1))
+			return 1;
+		s->placed[child->piece] = 0;
+		s->grid[cell].type = TOKEN_NONE;
+	}
+	return 0;
+}
+
+static int solve_best(search_t *s)
+{
+	return best(s, 0);
+}
+
+static void *run(void *arg)
+{
+	runner_t *runner = arg;
+	int solved = strategies[runner->index].solve(&runner->search);
+	if (runner->search.cancelled)
+		return NULL;
+	runner->result = solved ? RESULT_SOLVED : RESULT_UNSOLVABLE;
+	int none = 0;
+	atomic_compare_exchange_strong(&done, &none, runner->index + 1);
+	return NULL;
+}
+
+/* Races the strategies on puzzle p, returns the winner or -1 */
+static int race(int p, double *time)
+{
+	token_t layout[GRID_SIZE];
+	int targets = game_get_layout(p, layout);
+	atomic_store(&done, 0);
+	double start = now();
+	for (int i = 0; i < STRATEGY_COUNT; ++i) {
+		runner_t *runner = &runners[i];
+		runner->index = i;
+		runner->result = RESULT_NONE;
+		if (!strategies[i].enabled)
+			continue;
+		prepare(&runner->search, layout, targets);
+		if (pthread_create(&runner->thread, NULL, run, runner)) {
+			perror("pthread_create");
+			exit(1);
+		}
+	}
+	for (int i = 0; i < STRATEGY_COUNT; ++i)
+		if (strategies[i].enabled)
+			pthread_join(runners[i].thread, NULL);
+	*time = now() - start;
+	return atomic_load(&done) - 1;
+}
+
+/* Whether the winner's layout really solves the puzzle */
+static int check(search_t *s)
+{
+	trace_t trace;
+	return game_trace(s->grid, s->targets_extra, s->beam, &trace) &&
+		game_trace_solves(&trace, s->targets_req);
+}
+
+/*
+Lays out a laser, then targets and other tokens on random cells of its beam,
+and asks for the targets the beam hits, or one more now and then. Then up to
+CHECK_FREE of the tokens can move or rotate, and are moved and turned at
+random. Returns the targets to hit.
+*/
+static int random_board(token_t layout[GRID_SIZE])
+{
+	static const token_type_t types[CHECK_TOKENS] = {
+		TOKEN_LASER, TOKEN_TARGET, TOKEN_MIRROR, TOKEN_SPLITTER,
+		TOKEN_TARGET, TOKEN_CHECKPOINT, TOKEN_MIRROR, TOKEN_BLOCK,
+		TOKEN_TARGET
+	};
+	token_t grid[GRID_SIZE];
+	path_t beam[BEAM_MAX];
+	trace_t trace;
+	memset(layout, 0, GRID_SIZE * sizeof(token_t));
+	int count = 3 + rand() % (CHECK_TOKENS - 2);
+	for (int i = 0; i < count; ++i) {
+		int cells[GRID_SIZE];
+		int cell_count = 0;
+		memcpy(grid, layout, sizeof(grid));
+		if (game_trace(grid, GRID_SIZE, beam, &trace))
+			for (int p = 0; p < trace.path_count; ++p) {
+				int cell = GRID_WIDTH * beam[p].row +
+					beam[p].col;
+				if (layout[cell].type == TOKEN_NONE)
+					cells[cell_count++] = cell;
+			}
+		else
+			cells[cell_count++] = rand() % GRID_SIZE;
+		if (!cell_count)
+			break;
+		int cell = cells[rand() % cell_count];
+		layout[cell].type = types[i];
+		layout[cell].dir = rand() % 4;
+		layout[cell].slot = i;
+	}
+
+	memcpy(grid, layout, sizeof(grid));
+	game_trace(grid, GRID_SIZE, beam, &trace);
+	for (int cell = 0; cell < GRID_SIZE; ++cell)
+		layout[cell].req_target = layout[cell].type == TOKEN_TARGET &&
+			grid[cell].hit && rand() % 2;
+
+	for (int i = 0; i < CHECK_FREE; ++i) {
+		int cell;
+		do
+			cell = rand() % GRID_SIZE;
+		while (layout[cell].type == TOKEN_NONE);
+		token_t token = layout[cell];
+		token.can_move |= rand() % 3 != 0;
+		token.can_rotate |= rand() % 2;
+		if (token.can_rotate)
+			token.dir = rand() % 4;
+		layout[cell].type = TOKEN_NONE;
+		if (token.can_move)
+			do
+				cell = rand() % GRID_SIZE;
+			while (layout[cell].type != TOKEN_NONE);
+		layout[cell] = token;
+	}
+	return trace.targets_hit + !(rand() % 4);
+}
+
+/* Checks beam against brute on random boards */
+static int check_random(int boards)
+{
+	search_t *s = malloc(sizeof(search_t));
+	if (!s)
+		return 1;
+	srand(1);
+	int solvable = 0;
+	int bad = 0;
+	for (int i = 0; i < boards; ++i) {
+		token_t layout[GRID_SIZE];
+		int targets = random_board(layout);
+		prepare(s, layout, targets);
+		int beam = solve_beam(s);
+		int beam_ok = !beam || check(s);
+		prepare(s, layout, targets);
+		int brute = solve_brute(s);
+		solvable += brute;
+		if (beam != brute || !beam_ok) {
+			printf("board %i: beam %s, brute %s\n", i,
+				beam ? beam_ok ? "solved" : "WRONG" :
+				"unsolvable", brute ? "solved" : "unsolvable");
+			++bad;
+		}
+	}
+	free(s);
+	printf("%i boards, %i solvable, %i mismatches\n", boards, solvable,
+		bad);
+	return bad != 0;
+}
+
+static int enable(const char *name)
+{
+	for (int i = 0; i < STRATEGY_COUNT; ++i)
+		if (!strcmp(strategies[i].name, name)) {
+			strategies[i].enabled = 1;
+			return 0;
+		}
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	int chosen = 0;
+	int boards = 0;
+	int opt;
+	while ((opt = getopt(argc, argv, "s:c:")) != -1) {
+		switch (opt) {
+		case 'c':
+			boards = atoi(optarg);
+			break;
+		case 's':
+			if (!chosen)
+				for (int i = 0; i < STRATEGY_COUNT; ++i)
+					strategies[i].enabled = 0;
+			chosen = 1;
+			if (enable(optarg))
+				return usage(argv[0]);
+			break;
+		default:
+			return usage(argv[0]);
+		}
+	}
+	if (boards > 0 && optind == argc)
+		return check_random(boards);
+	if (optind != argc - 1)
+		return usage(argv[0]);
+
+	const char *pack = argv[optind];
+	FILE *f = fopen(pack, "rb");
+	if (!f) {
+		perror(pack);
+		return 1;
+	}
+	int size = fread(game_get_puzzles(), 1, PUZZLE_BYTES, f);
+	fclose(f);
+	memset(game_get_snapshots(), 0xff, SNAPSHOT_BYTES);
+	if (game_init(size, 1)) {
+		fprintf(stderr, "%s: bad pack\n", pack);
+		return 1;
+	}
+
+	int enabled = 0;
+	for (int i = 0; i < STRATEGY_COUNT; ++i)
+		enabled += strategies[i].enabled;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cores < enabled)
+		fprintf(stderr, "%s: %i strategies share %li cores\n", argv[0],
+			enabled, cores);
+
+	int failed = 0;
+	int worst = 0;
+	double worst_time = 0;
+	double total = 0;
+	for (int p = 0; p < game_get_puzzle_count(); ++p) {
+		double time;
+		int winner = race(p, &time);
+		runner_t *runner = &runners[winner];
+		int ok = runner->result == RESULT_SOLVED &&
+			check(&runner->search);
+		const char *result = ok ? "solved" :
+			runner->result == RESULT_UNSOLVABLE ? "UNSOLVABLE" :
+			"WRONG";
+		failed |= !ok;
+		++strategies[winner].wins;
+		printf("%3i  %-10s  %-5s  %9.3f ms  %lu traces\n", p + 1,
+			result, strategies[winner].name, time * 1e3,
+			(unsigned long)runner->search.traces);
+		total += time;
+		if (time > worst_time) {
+			worst_time = time;
+			worst = p;
+		}
+	}
+	printf("wins:");
+	for (int i = 0; i < STRATEGY_COUNT; ++i)
+		if (strategies[i].enabled)
+			printf(" %s %i", strategies[i].name,
+				strategies[i].wins);
+	printf("\nworst %.3f ms (puzzle %i), total %.3f ms\n", worst_time * 1e3,
+		worst + 1, total * 1e3);
+	return failed;
+}
@@ -0,0 +1,52 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* Host stand-in for libprof, timing with the monotonic clock in nanoseconds */
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+typedef struct {
+	uint32_t rec;
+	uint32_t elapsed;
+} prof_t;
+
+static inline uint32_t prof_host_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+}
+
+static inline int prof_init(void)
+{
+	return 0;
+}
+
+#define prof_make() ((prof_t){1, 0})
+#define prof_enter(prof) { if (!--(prof).rec) (prof).elapsed -= prof_host_ns(); }
+#define prof_leave(prof) { if (!(prof).rec++) (prof).elapsed += prof_host_ns(); }
+
+static inline uint32_t prof_time(prof_t prof)
+{
+	return prof.elapsed / 1000;
+}
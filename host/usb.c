@@ -0,0 +1,119 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Local stand-in for the fxlink endpoint: fxlink messages are read from a file,
+FIFO or stdin instead of the calculator's bulk pipe, e.g.:
+	tools/laser-push.py --stdout PACK.dat | build_host/laser-link
+Replies sent with usb_fxlink_text() go to stdout.
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <gint/usb-ff-bulk.h>
+
+static int fd = -1;
+static bool eof;
+static uint32_t remaining;
+
+static uint32_t le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int read_all(void *data, int size)
+{
+	int done = 0;
+	while (done < size) {
+		ssize_t rc = read(fd, (char *)data + done, size - done);
+		if (rc <= 0) {
+			eof = true;
+			break;
+		}
+		done += rc;
+	}
+	return done;
+}
+
+int usb_host_open(const char *path)
+{
+	fd = strcmp(path, "-") ? open(path, O_RDONLY) : STDIN_FILENO;
+	eof = fd < 0;
+	return fd < 0;
+}
+
+bool usb_host_eof(void)
+{
+	return eof;
+}
+
+bool usb_is_open(void)
+{
+	return fd >= 0;
+}
+
+int usb_ff_bulk_input(void)
+{
+	return 0;
+}
+
+/* The wire format is little-endian, like the real fxlink */
+bool usb_fxlink_handle_messages(usb_fxlink_header_t *header)
+{
+	uint8_t raw[44];
+	usb_fxlink_drop_transaction();
+	if (eof || read_all(raw, sizeof(raw)) != sizeof(raw))
+		return false;
+	header->version = le32(raw);
+	header->size = le32(raw + 4);
+	header->transfer_size = le32(raw + 8);
+	memcpy(header->application, raw + 12, 16);
+	memcpy(header->type, raw + 28, 16);
+	remaining = header->size;
+	return true;
+}
+
+void usb_fxlink_drop_transaction(void)
+{
+	char buf[256];
+	while (remaining && !eof) {
+		int size = remaining < sizeof(buf) ? remaining : sizeof(buf);
+		remaining -= read_all(buf, size);
+	}
+}
+
+int usb_read_sync(int pipe, void *data, int size, bool use_dma)
+{
+	(void)pipe;
+	(void)use_dma;
+	if ((uint32_t)size > remaining)
+		size = remaining;
+	int done = read_all(data, size);
+	remaining -= done;
+	return done;
+}
+
+void usb_fxlink_text(char const *text, int size)
+{
+	fwrite(text, 1, size, stdout);
+	fflush(stdout);
+}
@@ -0,0 +1,171 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+How to benchmark a calculator:
+1. Run: fxlink -iw
+2. Connect the calculator via USB then press EXIT (don't press F1 - F3)
+3. Press "^" in the game
+
+Every puzzle of the pack is loaded, traced and drawn BENCH_ITERATIONS times
+each, timed by libprof with a hardware timer. The screen shows the average
+and slowest puzzle, and one CSV line per puzzle is sent over USB:
+	# laser bench: hwcalc H, hwmpu M, N iterations
+	puzzle,id,load_ns,laser_ns,display_ns,first_us,check_us
+Times are per iteration. The load time includes the snapshot check of
+game_reload_puzzle(), and every draw is a full redraw. The editor check
+runs once per puzzle, from scratch: first_us is the time until the editor
+header shows a result, and check_us until it shows the final count.
+Without libprof (see timing.c) the G3A build runs nothing.
+*/
+
+#include <stdio.h>
+#ifndef FX9860G_G3A
+#include <gint/hardware.h>
+#include <gint/usb.h>
+#include <libprof.h>
+#endif
+#include "bench.h"
+#include "display.h"
+#include "editor.h"
+#include "game.h"
+#include "link.h"
+
+#ifndef FX9860G_G3A
+static uint32_t per_iteration(prof_t prof)
+{
+	return (uint64_t)prof_time(prof) * 1000 / BENCH_ITERATIONS;
+}
+
+static void bench_puzzle(bench_time_t *time)
+{
+	prof_t load = prof_make();
+	for (int n = 0; n < BENCH_ITERATIONS; ++n) {
+		prof_enter(load);
+		game_reload_puzzle();
+		prof_leave(load);
+	}
+
+	prof_t laser = prof_make();
+	for (int n = 0; n < BENCH_ITERATIONS; ++n) {
+		game_retrace();
+		prof_enter(laser);
+		game_laser();
+		prof_leave(laser);
+	}
+
+	prof_t draw = prof_make();
+	for (int n = 0; n < BENCH_ITERATIONS; ++n) {
+		display_invalidate();
+		prof_enter(draw);
+		display_game();
+		prof_leave(draw);
+	}
+
+	prof_t first = prof_make();
+	prof_t check = prof_make();
+	editor_forget();
+	prof_enter(first);
+	prof_enter(check);
+	editor_start();
+	while (editor_result() == EDITOR_BUSY)
+		editor_check();
+	prof_leave(first);
+	while (editor_check())
+		;
+	prof_leave(check);
+	editor_stop();
+	editor_forget();
+
+	time->load = per_iteration(load);
+	time->laser = per_iteration(laser);
+	time->display = per_iteration(draw);
+	time->first = prof_time(first);
+	time->check = prof_time(check);
+}
+
+static void add_time(bench_time_t *sum, bench_time_t *max,
+			const bench_time_t *time)
+{
+	sum->load += time->load;
+	sum->laser += time->laser;
+	sum->display += time->display;
+	sum->first += time->first;
+	sum->check += time->check;
+	if (time->load > max->load)
+		max->load = time->load;
+	if (time->laser > max->laser)
+		max->laser = time->laser;
+	if (time->display > max->display)
+		max->display = time->display;
+	if (time->first > max->first)
+		max->first = time->first;
+	if (time->check > max->check)
+		max->check = time->check;
+}
+#endif
+
+/*
+Benchmarks every puzzle of the pack, then goes back to the current one.
+Returns nonzero if there is nothing to time with.
+*/
+int bench_run(bench_t *bench)
+{
+#ifndef FX9860G_G3A
+	char line[64];
+	int current = game_get_puzzle_index();
+	int count = game_get_puzzle_count();
+	bench->sent = usb_is_open();
+	snprintf(line, sizeof(line),
+		"# laser bench: hwcalc %i, hwmpu %i, %i iterations\n",
+		(int)gint[HWCALC], (int)gint[HWMPU], BENCH_ITERATIONS);
+	link_reply(line);
+	link_reply("puzzle,id,load_ns,laser_ns,display_ns,first_us,"
+		"check_us\n");
+
+	bench_time_t sum = {0}, max = {0};
+	for (int i = 0; i < count; ++i) {
+		game_goto_puzzle(i);
+		bench_time_t time;
+		bench_puzzle(&time);
+		add_time(&sum, &max, &time);
+		snprintf(line, sizeof(line), "%i,%i,%lu,%lu,%lu,%lu,%lu\n",
+			i + 1, game_get_puzzle_id(), (unsigned long)time.load,
+			(unsigned long)time.laser,
+			(unsigned long)time.display,
+			(unsigned long)time.first,
+			(unsigned long)time.check);
+		link_reply(line);
+	}
+	game_goto_puzzle(current);
+
+	bench->puzzles = count;
+	bench->avg.load = sum.load / count;
+	bench->avg.laser = sum.laser / count;
+	bench->avg.display = sum.display / count;
+	bench->avg.first = sum.first / count;
+	bench->avg.check = sum.check / count;
+	bench->max = max;
+	return 0;
+#else
+	(void)bench;
+	return 1;
+#endif
+}
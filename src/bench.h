@@ -0,0 +1,43 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define BENCH_ITERATIONS 16
+
+/* Nanoseconds per iteration, but microseconds for the editor check */
+typedef struct {
+	uint32_t load;
+	uint32_t laser;
+	uint32_t display;
+	uint32_t first;
+	uint32_t check;
+} bench_time_t;
+
+typedef struct {
+	int puzzles;
+	bench_time_t avg;
+	bench_time_t max;
+	int sent;
+} bench_t;
+
+int bench_run(bench_t *bench);
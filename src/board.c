@@ -0,0 +1,279 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+What the board shows, independent of how it is drawn: sprite and beam glyph
+indices, the cells in view, and the state of each cell in a frame.
+*/
+
+#include <string.h>
+#include "board.h"
+#include "editor.h"
+#include "record.h"
+
+#define GLYPH_LASER_OUT 25
+#define GLYPH_LASER_IN 29
+#define GLYPH_HIT 33
+
+#define CELL_VALUES 256
+
+#define BADGE_NONE 0
+#define BADGE_MOVE 1
+#define BADGE_ROTATE 2
+#define BADGE_COUNT 3
+
+#define SPRITE_BLOCK 0
+#define SPRITE_CHECKPOINT_NS 1
+#define SPRITE_CHECKPOINT_EW 2
+#define SPRITE_LASER 3
+#define SPRITE_MIRROR_NWSE 7
+#define SPRITE_MIRROR_NESW 8
+#define SPRITE_SPLITTER_NWSE 9
+#define SPRITE_SPLITTER_NESW 10
+#define SPRITE_TARGET 11
+#define SPRITE_TARGET_REQ 15
+
+static int8_t cell_sprites[CELL_VALUES];
+
+/*
+Thumbnails are built when first shown, or ahead of time while waiting for
+keys, and kept until another pack is loaded.
+*/
+static thumb_t thumbs[PUZZLE_MAX];
+static uint8_t thumb_built[PUZZLE_MAX];
+static int thumb_pack = -1;
+
+/* Index of the token image in img_tokens, see tools/atlas.py */
+static int token_sprite(token_type_t type, dir_t dir, int req_target)
+{
+	switch (type) {
+	case TOKEN_NONE:
+		break;
+	case TOKEN_BLOCK:
+		return SPRITE_BLOCK;
+	case TOKEN_CHECKPOINT:
+		return (dir == DIR_NORTH || dir == DIR_SOUTH) ?
+			SPRITE_CHECKPOINT_NS : SPRITE_CHECKPOINT_EW;
+	case TOKEN_LASER:
+		return SPRITE_LASER + dir;
+	case TOKEN_MIRROR:
+		return (dir == DIR_NORTH || dir == DIR_SOUTH) ?
+			SPRITE_MIRROR_NWSE : SPRITE_MIRROR_NESW;
+	case TOKEN_SPLITTER:
+		return (dir == DIR_NORTH || dir == DIR_SOUTH) ?
+			SPRITE_SPLITTER_NWSE : SPRITE_SPLITTER_NESW;
+	case TOKEN_TARGET:
+		return (req_target ? SPRITE_TARGET_REQ : SPRITE_TARGET) + dir;
+	}
+	return -1;
+}
+
+/*
+Cell value, indexing cell_sprites:
+	7 6 5 | 4 3 | 2          | 1        | 0
+	TYPE  | DIR | REQ_TARGET | CAN_MOVE | CAN_ROTATE
+*/
+static int cell_value(token_t *token)
+{
+	return (token->type << 5) | (token->dir << 3) |
+		((token->req_target & 0x01) << 2) |
+		((token->can_move & 0x01) << 1) | (token->can_rotate & 0x01);
+}
+
+void board_init(void)
+{
+	for (int value = 0; value < CELL_VALUES; ++value) {
+		int sprite = token_sprite(value >> 5, (value >> 3) & 0x03,
+						(value >> 2) & 0x01);
+		if (sprite >= 0) {
+			int badge = BADGE_NONE;
+			if (value & 0x02)
+				badge = BADGE_MOVE;
+			else if (value & 0x01)
+				badge = BADGE_ROTATE;
+			sprite = BADGE_COUNT * sprite + badge;
+		}
+		cell_sprites[value] = sprite;
+	}
+}
+
+/* Index of the token image in img_tokens, or -1 for an empty cell */
+int board_sprite(token_t *token)
+{
+	return cell_sprites[cell_value(token)];
+}
+
+/* Index of the glyph in img_beam for a beam path, see tools/atlas.py */
+int board_glyph(path_t *path, token_t *token)
+{
+	switch (token->type) {
+	case TOKEN_CHECKPOINT:
+		if (path->exit == LOC_STOP)
+			return -1;
+		break;
+	case TOKEN_LASER:
+		if (path->entry == LOC_STOP)
+			return GLYPH_LASER_OUT + token->dir;
+		return GLYPH_LASER_IN + path->entry;
+	case TOKEN_TARGET:
+		if (path->exit != LOC_STOP)
+			break;
+		if ((int)path->entry == (int)token->dir)
+			return GLYPH_HIT + token->dir;
+		return -1;
+	default:
+		break;
+	}
+	return 5 * path->entry + path->exit;
+}
+
+bool board_is_static(token_t *token)
+{
+	return token->type != TOKEN_NONE && !token->can_move &&
+		!token->can_rotate;
+}
+
+bool board_in_view(const view_t *view, int row, int col)
+{
+	return row >= view->row && row < view->row + view->rows &&
+		col >= view->col && col < view->col + view->cols;
+}
+
+/* Scrolls the view just enough to show the cursor */
+void board_scroll(view_t *view)
+{
+	int row = game_get_cursor_row();
+	int col = game_get_cursor_col();
+	if (row < view->row)
+		view->row = row;
+	else if (row >= view->row + view->rows)
+		view->row = row - view->rows + 1;
+	if (col < view->col)
+		view->col = col;
+	else if (col >= view->col + view->cols)
+		view->col = col - view->cols + 1;
+}
+
+/* Records what the view shows, to compare with the frames drawn before */
+void board_frame(const view_t *view, frame_t *frame)
+{
+	memset(frame, 0, sizeof(*frame));
+	for (int row = view->row; row < view->row + view->rows; ++row)
+		for (int col = view->col; col < view->col + view->cols; ++col) {
+			cell_state_t *cell = &frame->cells[GRID_WIDTH * row + col];
+			token_t *token = game_get_token(row, col);
+			cell->type = token->type;
+			if (token->type != TOKEN_NONE) {
+				cell->dir = token->dir;
+				cell->flags = token->can_move |
+					(token->can_rotate << 1) |
+					(token->req_target << 2);
+			}
+			if (game_is_selection(row, col))
+				cell->mark = 2;
+			else if (game_is_cursor(row, col))
+				cell->mark = 1;
+			else if (game_is_preview(row, col))
+				cell->mark = 3;
+		}
+	int count = game_get_path_count();
+	for (int i = 0; i < count; ++i) {
+		path_t *path = game_get_path(i);
+		if (!board_in_view(view, path->row, path->col))
+			continue;
+		cell_state_t *cell =
+			&frame->cells[GRID_WIDTH * path->row + path->col];
+		cell->beam |= 1UL << (5 * path->entry + path->exit);
+	}
+	frame->header.id = game_get_puzzle_id();
+	frame->header.targets_req = get_targets_req();
+	frame->header.targets_hit = get_targets_hit();
+	frame->header.solved = game_is_solved();
+	frame->header.winner = game_is_total_winner();
+	frame->header.recording = record_is_on() + record_is_full();
+	frame->header.editor = editor_result();
+	frame->header.save_error = editor_save_error();
+}
+
+static void build_thumb(int i)
+{
+	token_t grid[GRID_SIZE];
+	game_get_layout(i, grid);
+	thumb_t *thumb = &thumbs[i];
+	memset(thumb, 0, sizeof(*thumb));
+
+	// Light border
+	for (int y = 0; y < THUMB_SIZE; ++y)
+		thumb->planes[0][y] = 0x8001;
+	thumb->planes[0][0] = 0xffff;
+	thumb->planes[0][THUMB_SIZE - 1] = 0xffff;
+
+	// Static tokens dark, the others black
+	for (int cell = 0; cell < GRID_SIZE; ++cell) {
+		token_t *token = &grid[cell];
+		if (token->type == TOKEN_NONE)
+			continue;
+		int planes = board_is_static(token) ? 0x02 : 0x03;
+		int y = 3 * (cell / GRID_WIDTH) + 1;
+		uint16_t bits = 0xc000 >> (3 * (cell % GRID_WIDTH) + 1);
+		for (int plane = 0; plane < 2; ++plane)
+			if (planes & (1 << plane)) {
+				thumb->planes[plane][y] |= bits;
+				thumb->planes[plane][y + 1] |= bits;
+			}
+	}
+	thumb_built[i] = 1;
+}
+
+static void check_thumb_pack(void)
+{
+	if (thumb_pack != game_get_pack_count()) {
+		memset(thumb_built, 0, sizeof(thumb_built));
+		thumb_pack = game_get_pack_count();
+	}
+}
+
+/* Thumbnail of a puzzle in the pack, built first if needed */
+const thumb_t *board_thumb(int i)
+{
+	check_thumb_pack();
+	if (!thumb_built[i])
+		build_thumb(i);
+	return &thumbs[i];
+}
+
+/*
+Idle task that builds one missing thumbnail, the puzzles after the current
+one first. Returns 0 once every thumbnail of the pack is built.
+*/
+int board_prefetch(void)
+{
+	check_thumb_pack();
+	int count = game_get_puzzle_count();
+	int first = game_get_puzzle_index();
+	for (int n = 1; n <= count; ++n) {
+		int i = (first + n) % count;
+		if (!thumb_built[i]) {
+			build_thumb(i);
+			return 1;
+		}
+	}
+	return 0;
+}
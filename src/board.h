@@ -0,0 +1,78 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "game.h"
+
+#define THUMB_SIZE 16
+
+typedef struct {
+	uint32_t beam;
+	uint8_t type;
+	uint8_t dir;
+	uint8_t flags;
+	uint8_t mark;
+} cell_state_t;
+
+typedef struct {
+	uint16_t id;
+	uint8_t targets_req;
+	uint8_t targets_hit;
+	uint8_t solved;
+	uint8_t winner;
+	uint8_t recording;
+	uint8_t editor;
+	uint8_t save_error;
+} header_state_t;
+
+/* What was drawn in a frame, to find the regions that need redrawing */
+typedef struct {
+	cell_state_t cells[GRID_SIZE];
+	header_state_t header;
+} frame_t;
+
+/* Board cells shown on screen */
+typedef struct {
+	int row;
+	int col;
+	int rows;
+	int cols;
+} view_t;
+
+/*
+Level select thumbnail, 16x16 pixels with one bit per pixel and gray plane,
+leftmost pixel in the high bit, and a 3x3 pixel area per cell.
+*/
+typedef struct {
+	uint16_t planes[2][THUMB_SIZE];
+} thumb_t;
+
+void board_init(void);
+int board_sprite(token_t *token);
+int board_glyph(path_t *path, token_t *token);
+bool board_is_static(token_t *token);
+bool board_in_view(const view_t *view, int row, int col);
+void board_scroll(view_t *view);
+void board_frame(const view_t *view, frame_t *frame);
+const thumb_t *board_thumb(int i);
+int board_prefetch(void);
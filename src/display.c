@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022, 2025  Jeffry Johnston
+Copyright (C) 2022, 2025, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -22,53 +22,49 @@ along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
 #include <gint/gint.h>
 #include <gint/gray.h>
 #include <gint/hardware.h>
+#include <string.h>
+#include "board.h"
+#include "display.h"
+#include "editor.h"
 #include "game.h"
+#include "library.h"
+#include "record.h"
+#include "sprite.h"
+#include "timing.h"
+#include "trace.h"
 
-#define CORNER_NE 0
-#define CORNER_SE 1
-#define CORNER_SW 2
-#define CORNER_NW 3
+#define PACK_ROWS 7
+
+#define THUMB_ROWS 3
+
+#define HEADER_LEFT 94
+#define VIEW_ROWS (GRID_HEIGHT < 5 ? GRID_HEIGHT : 5)
+#define VIEW_COLS (GRID_WIDTH < 5 ? GRID_WIDTH : 5)
+#define OVERVIEW_CELL 6
+
+#define GLYPH_SIZE 13
+#define TOKEN_SIZE 11
+
+#define ROW_WORDS (DWIDTH / 32)
+#define PLANE_WORDS (ROW_WORDS * DHEIGHT)
+
+typedef enum {
+	MODE_NONE,
+	MODE_MONO,
+	MODE_GRAY
+} display_mode_t;
 
 extern bopti_image_t img_background;
 extern bopti_image_t img_background_cg100;
-extern bopti_image_t img_can_move;
-extern bopti_image_t img_can_rotate;
+extern bopti_image_t img_beam;
 extern bopti_image_t img_cursor;
-extern bopti_image_t img_hit_n;
-extern bopti_image_t img_hit_e;
-extern bopti_image_t img_hit_s;
-extern bopti_image_t img_hit_w;
-extern bopti_image_t img_logo;
 extern bopti_image_t img_selection;
 extern bopti_image_t img_solved;
 extern bopti_image_t img_target_hit;
 extern bopti_image_t img_target_missed;
-extern bopti_image_t img_token_block;
-extern bopti_image_t img_token_checkpoint_ns;
-extern bopti_image_t img_token_checkpoint_ew;
-extern bopti_image_t img_token_laser_n;
-extern bopti_image_t img_token_laser_e;
-extern bopti_image_t img_token_laser_s;
-extern bopti_image_t img_token_laser_w;
-extern bopti_image_t img_token_mirror_nesw;
-extern bopti_image_t img_token_mirror_nwse;
-extern bopti_image_t img_token_splitter_nesw;
-extern bopti_image_t img_token_splitter_nwse;
-extern bopti_image_t img_token_target_n;
-extern bopti_image_t img_token_target_e;
-extern bopti_image_t img_token_target_s;
-extern bopti_image_t img_token_target_w;
-extern bopti_image_t img_token_target_req_n;
-extern bopti_image_t img_token_target_req_e;
-extern bopti_image_t img_token_target_req_s;
-extern bopti_image_t img_token_target_req_w;
-extern bopti_image_t img_help1;
-extern bopti_image_t img_help1_cg100;
-extern bopti_image_t img_help2;
-extern bopti_image_t img_help2_cg100;
+extern bopti_image_t img_tokens;
 extern font_t font_laser;
 
-bool display_is_gray;
 uint8_t debug_display = 0;
 #ifdef FX9860G_G3A
 uint8_t debug_r;
@@ -79,6 +75,27 @@ uint16_t debug_light;
 uint16_t debug_dark;
 #endif
 
+static display_mode_t mode = MODE_NONE;
+#ifdef FX9860G_G3A
+static uint16_t gray_color;
+#else
+static uint16_t gray_light;
+static uint16_t gray_dark;
+#endif
+
+static frame_t frames[2];
+static int frame_i;
+static int frames_valid;
+
+// Background and tokens that never change, one copy per gray plane
+static uint32_t static_layer[2][PLANE_WORDS];
+static int static_load = -1;
+static view_t static_view;
+
+// Board cells on screen, and what they show in the frame being drawn
+static view_t view = {0, 0, VIEW_ROWS, VIEW_COLS};
+static frame_t current;
+
 #ifdef FX9860G_G3A
 static uint16_t rgb565(void)
 {
@@ -88,11 +105,13 @@ static uint16_t rgb565(void)
 
 void display_init(void)
 {
+	board_init();
 #ifdef FX9860G_G3A
 	debug_r = 28;
 	debug_g = 0;
 	debug_b = 5;
-	dgray_setcolors(DGRAY_BLACK_DEFAULT, DGRAY_DARK_DEFAULT, rgb565(), DGRAY_WHITE_DEFAULT);
+	gray_color = rgb565();
+	dgray_setcolors(DGRAY_BLACK_DEFAULT, DGRAY_DARK_DEFAULT, gray_color, DGRAY_WHITE_DEFAULT);
 #else
 	if (gint[HWCALC] == HWCALC_G35PE2) {
 		debug_light = 1006;
@@ -106,32 +125,57 @@ void display_init(void)
 
 void display_init_mono(const bool clear)
 {
-	dgray(DGRAY_OFF);
-	dfont(&font_laser);
+	if (mode == MODE_GRAY) {
+		dgray(DGRAY_OFF);
+		TRACE_ADD(TRACE_GRAY_OFF, TRACE_INSTANT);
+	}
+	if (mode == MODE_NONE)
+		dfont(&font_laser);
 	if (clear)
 		dclear(C_WHITE);
-	display_is_gray = false;
+	mode = MODE_MONO;
+	frames_valid = 0;
 }
 
+/* Starts the gray engine if needed; settings only change with the debug keys */
 static void display_init_gray(void)
 {
 #ifdef FX9860G_G3A
-	dgray_setcolors(DGRAY_BLACK_DEFAULT, DGRAY_DARK_DEFAULT, rgb565(), DGRAY_WHITE_DEFAULT);
+	if (mode == MODE_NONE || gray_color != rgb565()) {
+		gray_color = rgb565();
+		dgray_setcolors(DGRAY_BLACK_DEFAULT, DGRAY_DARK_DEFAULT, gray_color, DGRAY_WHITE_DEFAULT);
+	}
 #else
-	if (gint[HWCALC] == HWCALC_G35PE2)
-		dgray_setdelays(debug_light, debug_light);
-	else
-		dgray_setdelays(debug_light, debug_dark);
+	if (mode == MODE_NONE || gray_light != debug_light ||
+			gray_dark != debug_dark) {
+		gray_light = debug_light;
+		gray_dark = debug_dark;
+		if (gint[HWCALC] == HWCALC_G35PE2)
+			dgray_setdelays(gray_light, gray_light);
+		else
+			dgray_setdelays(gray_light, gray_dark);
+	}
 #endif
-	dfont(&font_laser);
+	if (mode == MODE_GRAY)
+		return;
+	if (mode == MODE_NONE)
+		dfont(&font_laser);
 	dgray(DGRAY_ON);
-	display_is_gray = true;
+	TRACE_ADD(TRACE_GRAY_ON, TRACE_INSTANT);
+	mode = MODE_GRAY;
+	frames_valid = 0;
+}
+
+static void sprite_run(int x1, int x2, int y, int level)
+{
+	static const int colors[] = {C_WHITE, C_LIGHT, C_DARK, C_BLACK};
+	drect(x1, y, x2, y, colors[level]);
 }
 
 void display_menu_return(void)
 {
 	display_init_mono(true);
-	dimage(24, 13, &img_logo);
+	sprite_draw(&sprite_logo, 24, 13, sprite_run);
 	dprint(20, 45, C_BLACK, "PRESS ANY KEY TO CONTINUE");
 }
 
@@ -157,284 +201,165 @@ static void debug(void)
 	dprint(96, 19, C_BLACK, "%u", debug_light);
 	drect(0, 25, 31, 46, C_LIGHT);
 	drect(95, 25, 127, 46, C_DARK);
+
+	// Frame time breakdown in microseconds, or milliseconds with an M
+	static const char *names[TIMING_COUNT] = {"KEY", "LSR", "BKG", "TOK",
+						"BEAM", "UPD"};
+	drect(33, 19, 94, 62, C_WHITE);
+	dtext(34, 20, C_BLACK, "US");
+	dtext_opt(61, 20, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, "MIN", -1);
+	dtext_opt(77, 20, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, "AVG", -1);
+	dtext_opt(93, 20, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, "MAX", -1);
+	for (int t = 0; t < TIMING_COUNT; ++t) {
+		uint32_t times[3];
+		timing_get(t, &times[0], &times[1], &times[2]);
+		int y = 6 * t + 27;
+		dtext(34, y, C_BLACK, names[t]);
+		for (int i = 0; i < 3; ++i)
+			dprint_opt(16 * i + 61, y, C_BLACK, C_NONE, DTEXT_RIGHT,
+				DTEXT_TOP, times[i] < 10000 ? "%u" : "%uM",
+				(unsigned int)(times[i] < 10000 ? times[i] :
+					times[i] / 1000));
+	}
 #endif
 }
 
-static void draw_loc(loc_t loc, int x, int y)
-{
-	switch (loc) {
-	case LOC_NORTH:
-		dline(x + 6, y, x + 6, y + 5, C_LIGHT);
-		break;
-	case LOC_EAST:
-		dline(x + 12, y + 6, x + 7, y + 6, C_LIGHT);
-		break;
-	case LOC_SOUTH:
-		dline(x + 6, y + 12, x + 6, y + 7, C_LIGHT);
-		break;
-	case LOC_WEST:
-		dline(x, y + 6, x + 5, y + 6, C_LIGHT);
-		break;
-	case LOC_STOP:
-		break;
-	}
+/* Left and top of a cell box on screen */
+static int cell_x(int col)
+{
+	return 12 * (col - view.col) + 33;
 }
 
-static void draw_simple(loc_t entry, loc_t exit, int x, int y)
-{
-	draw_loc(entry, x, y);
-	draw_loc(exit, x, y);
-	if (!((entry + exit) & 0x01))
-		dpixel(x + 6, y + 6, C_LIGHT);
-}
-
-static void draw_laser(void)
-{
-	int count = game_get_path_count();
-	for (int i = 0; i < count; ++i) {
-		path_t *path = game_get_path(i);
-		int row = path->row;
-		int col = path->col;
-		int y = 12 * row + 1;
-		int x = 12 * col + 33;
-
-		token_t *token = game_get_token(row, col);
-		switch (token->type) {
-		case TOKEN_NONE:
-		case TOKEN_BLOCK:
-		case TOKEN_MIRROR:
-		case TOKEN_SPLITTER:
-			draw_simple(path->entry, path->exit, x, y);
-			break;
-		case TOKEN_CHECKPOINT:
-			if (path->exit != LOC_STOP)
-				draw_simple(path->entry, path->exit, x, y);
-			break;
-		case TOKEN_LASER:
-			if (path->entry == LOC_STOP)
-				switch (token->dir) {
-				case DIR_NORTH:
-					dline(x + 6, y, x + 6, y + 4, C_LIGHT);
-					break;
-				case DIR_EAST:
-					dline(x + 12, y + 6, x + 8, y + 6,
-						C_LIGHT);
-					break;
-				case DIR_SOUTH:
-					dline(x + 6, y + 12, x + 6, y + 8,
-						C_LIGHT);
-					break;
-				case DIR_WEST:
-					dline(x, y + 6, x + 4, y + 6, C_LIGHT);
-					break;
-				}
-			else
-				switch (path->entry) {
-				case LOC_NORTH:
-					dline(x + 6, y, x + 6, y + 2, C_LIGHT);
-					break;
-				case LOC_EAST:
-					dline(x + 12, y + 6, x + 10, y + 6,
-						C_LIGHT);
-					break;
-				case LOC_SOUTH:
-					dline(x + 6, y + 12, x + 6, y + 10,
-						C_LIGHT);
-					break;
-				case LOC_WEST:
-					dline(x, y + 6, x + 2, y + 6, C_LIGHT);
-					break;
-				case LOC_STOP:
-					break;
-				}
-			break;
-		case TOKEN_TARGET:
-			if (path->exit == LOC_STOP) {
-				if ((int)path->entry == (int)token->dir)
-					switch (token->dir) {
-					case DIR_NORTH:
-						dimage(x + 3, y + 1,
-							&img_hit_n);
-						break;
-					case DIR_EAST:
-						dimage(x + 8, y + 3,
-							&img_hit_e);
-						break;
-					case DIR_SOUTH:
-						dimage(x + 3, y + 8,
-							&img_hit_s);
-						break;
-					case DIR_WEST:
-						dimage(x + 1, y + 3,
-							&img_hit_w);
-						break;
-					}
-			} else {
-				draw_simple(path->entry, path->exit, x, y);
-			}
-			break;
-		}
-	}
+static int cell_y(int row)
+{
+	return 12 * (row - view.row) + 1;
 }
 
-void display_game()
+static void draw_frame(int x1, int y1, int x2, int y2, int color)
 {
-	// Prepare gray engine
-	display_init_gray();
+	dline(x1, y1, x2, y1, color);
+	dline(x1, y2, x2, y2, color);
+	dline(x1, y1, x1, y2, color);
+	dline(x2, y1, x2, y2, color);
+}
 
-	// Draw background image
-	dimage(0, 0, (gint[HWCALC] == HWCALC_FXCG100) ? &img_background_cg100 : &img_background);
+/* Draws the beam paths through a cell, from the frame being drawn */
+static void draw_beam(int row, int col)
+{
+	uint32_t beam = current.cells[GRID_WIDTH * row + col].beam;
+	if (!beam)
+		return;
+	token_t *token = game_get_token(row, col);
+	for (int i = 0; beam; ++i, beam >>= 1) {
+		if (!(beam & 0x01))
+			continue;
+		path_t path = {row, col, i / 5, i % 5};
+		int glyph = board_glyph(&path, token);
+		if (glyph >= 0)
+			dsubimage(cell_x(col), cell_y(row), &img_beam,
+				GLYPH_SIZE * glyph, 0, GLYPH_SIZE, GLYPH_SIZE,
+				DIMAGE_NONE);
+	}
+}
 
-	// Draw each token
-	for (int row = 0; row < GRID_HEIGHT; ++row) {
-		int y = 12 * row + 2;
-		for (int col = 0; col < GRID_WIDTH; ++col) {
-			int x = 12 * col + 34;
-			token_t *token = game_get_token(row, col);
-			bopti_image_t *img = NULL;
-			int corner = CORNER_NE;
-			int invert = 0;
-			switch (token->type) {
-			case TOKEN_NONE:
-				break;
-			case TOKEN_BLOCK:
-				img = &img_token_block;
-				invert = 1;
-				break;
-			case TOKEN_CHECKPOINT:
-				switch (token->dir) {
-				case DIR_NORTH:
-				case DIR_SOUTH:
-					img = &img_token_checkpoint_ns;
-					break;
-				case DIR_EAST:
-				case DIR_WEST:
-					img = &img_token_checkpoint_ew;
-					break;
-				}
-				invert = 1;
-				break;
-			case TOKEN_LASER:
-				switch (token->dir) {
-				case DIR_NORTH:
-					img = &img_token_laser_n;
-					break;
-				case DIR_EAST:
-					img = &img_token_laser_e;
-					break;
-				case DIR_SOUTH:
-					img = &img_token_laser_s;
-					break;
-				case DIR_WEST:
-					img = &img_token_laser_w;
-					break;
-				}
-				break;
-			case TOKEN_MIRROR:
-				switch (token->dir) {
-				case DIR_NORTH:
-				case DIR_SOUTH:
-					img = &img_token_mirror_nwse;
-					break;
-				case DIR_EAST:
-				case DIR_WEST:
-					img = &img_token_mirror_nesw;
-					corner = CORNER_NW;
-					break;
-				}
-				break;
-			case TOKEN_SPLITTER:
-				switch (token->dir) {
-				case DIR_NORTH:
-				case DIR_SOUTH:
-					img = &img_token_splitter_nwse;
-					break;
-				case DIR_EAST:
-				case DIR_WEST:
-					img = &img_token_splitter_nesw;
-					corner = CORNER_NW;
-					break;
-				}
-				break;
-			case TOKEN_TARGET:
-				if (token->req_target)
-					switch (token->dir) {
-					case DIR_NORTH:
-						img = &img_token_target_req_n;
-						corner = CORNER_SW;
-						break;
-					case DIR_EAST:
-						img = &img_token_target_req_e;
-						corner = CORNER_NW;
-						break;
-					case DIR_SOUTH:
-						img = &img_token_target_req_s;
-						break;
-					case DIR_WEST:
-						img = &img_token_target_req_w;
-						corner = CORNER_SE;
-						break;
-					}
-				else
-					switch (token->dir) {
-					case DIR_NORTH:
-						img = &img_token_target_n;
-						corner = CORNER_SW;
-						break;
-					case DIR_EAST:
-						img = &img_token_target_e;
-						corner = CORNER_NW;
-						break;
-					case DIR_SOUTH:
-						img = &img_token_target_s;
-						break;
-					case DIR_WEST:
-						img = &img_token_target_w;
-						corner = CORNER_SE;
-						break;
-					}
-				break;
-			}
+static void draw_token(int row, int col)
+{
+	int sprite = board_sprite(game_get_token(row, col));
+	if (sprite >= 0)
+		dsubimage(cell_x(col) + 1, cell_y(row) + 1, &img_tokens,
+			TOKEN_SIZE * sprite, 0, TOKEN_SIZE, TOKEN_SIZE,
+			DIMAGE_NONE);
+}
 
-			if (img) {
-				dimage(x, y, img);
+/* The selection, cursor or preview mark, never part of the static layer */
+static void draw_mark(int row, int col)
+{
+	int y = cell_y(row) + 1;
+	int x = cell_x(col) + 1;
+	if (game_is_selection(row, col))
+		dimage(x - 1, y - 1, &img_selection);
+	else if (game_is_cursor(row, col))
+		dimage(x - 1, y - 1, &img_cursor);
+	else if (game_is_preview(row, col))
+		draw_frame(x + 1, y + 1, x + 9, y + 9, C_LIGHT);
+}
 
-				img = NULL;
-				if (token->can_move)
-					img = &img_can_move;
-				else if (token->can_rotate)
-					img = &img_can_rotate;
-			}
+/* Draws what is not in the static layer, culled to the viewport */
+static void draw_board(int row1, int row2, int col1, int col2)
+{
+	if (row1 < view.row)
+		row1 = view.row;
+	if (row2 > view.row + view.rows - 1)
+		row2 = view.row + view.rows - 1;
+	if (col1 < view.col)
+		col1 = view.col;
+	if (col2 > view.col + view.cols - 1)
+		col2 = view.col + view.cols - 1;
+
+	timing_enter(TIMING_TOKENS);
+	for (int row = row1; row <= row2; ++row)
+		for (int col = col1; col <= col2; ++col) {
+			if (!board_is_static(game_get_token(row, col)))
+				draw_token(row, col);
+			draw_mark(row, col);
+		}
+	timing_leave(TIMING_TOKENS);
+	timing_enter(TIMING_BEAM);
+	for (int row = row1; row <= row2; ++row)
+		for (int col = col1; col <= col2; ++col)
+			draw_beam(row, col);
+	timing_leave(TIMING_BEAM);
+}
 
-			if (img) {
-				int y2 = y;
-				int x2 = x;
-				switch (corner) {
-				case CORNER_NE:
-					x2 += 8;
-					break;
-				case CORNER_SE:
-					x2 += 8;
-					y2 += 8;
-					break;
-				case CORNER_SW:
-					y2 += 8;
-					break;
-				case CORNER_NW:
-					break;
-				}
-				dimage(x2, y2, img);
-				if (invert)
-					drect(x2, y2, x2 + 2, y2 + 2, C_INVERT);
-			}
+static bool is_static_valid(void)
+{
+	return static_load == game_get_load_count() &&
+		static_view.row == view.row && static_view.col == view.col;
+}
 
-			if (game_is_selection(row, col))
-				dimage(x - 1, y - 1, &img_selection);
-			else if (game_is_cursor(row, col))
-				dimage(x - 1, y - 1, &img_cursor);
+/* Renders the static layer of the viewport into VRAM and keeps a copy */
+static void build_static(void)
+{
+	dimage(0, 0, (gint[HWCALC] == HWCALC_FXCG100) ? &img_background_cg100 : &img_background);
+	for (int row = view.row; row < view.row + view.rows; ++row)
+		for (int col = view.col; col < view.col + view.cols; ++col)
+			if (board_is_static(game_get_token(row, col)))
+				draw_token(row, col);
+
+	uint32_t *light, *dark;
+	dgray_getvram(&light, &dark);
+	memcpy(static_layer[0], light, sizeof(static_layer[0]));
+	memcpy(static_layer[1], dark, sizeof(static_layer[1]));
+	static_load = game_get_load_count();
+	static_view.row = view.row;
+	static_view.col = view.col;
+}
+
+/* Copies a rectangle of the static layer into VRAM */
+static void draw_static(int x, int y, int w, int h)
+{
+	timing_enter(TIMING_BACKGROUND);
+	uint32_t *planes[2];
+	dgray_getvram(&planes[0], &planes[1]);
+	for (int word = x / 32; word <= (x + w - 1) / 32; ++word) {
+		int left = x - 32 * word;
+		int right = x + w - 32 * word;
+		uint32_t mask = left > 0 ? 0xffffffff >> left : 0xffffffff;
+		if (right < 32)
+			mask &= ~(0xffffffff >> right);
+		for (int plane = 0; plane < 2; ++plane) {
+			uint32_t *src = &static_layer[plane][word];
+			uint32_t *dst = &planes[plane][word];
+			for (int i = ROW_WORDS * y; i < ROW_WORDS * (y + h);
+					i += ROW_WORDS)
+				dst[i] = (dst[i] & ~mask) | (src[i] & mask);
 		}
 	}
+	timing_leave(TIMING_BACKGROUND);
+}
 
+static void draw_header(void)
+{
 	// Draw puzzle ID, target completion, and solve/win status
 	dprint(114, 1, C_BLACK, "%i", game_get_puzzle_id());
 	for (int i = 0; i < get_targets_req(); ++i) {
@@ -446,11 +371,154 @@ void display_game()
 		dimage(101, 1, &img_solved);
 	if (game_is_total_winner())
 		dprint(98, 29, C_LIGHT, "YOU WIN!");
+	if (record_is_on())
+		dtext(98, 57, C_BLACK, record_is_full() ? "FULL" : "REC");
+	if (editor_label())
+		dtext(98, 49, C_BLACK, editor_label());
+}
+
+/* Redraws a cell box. Boxes share their edges, so the neighbors are drawn too,
+clipped to the box. */
+static void redraw_cell(int row, int col)
+{
+	int x = cell_x(col);
+	int y = cell_y(row);
+	struct dwindow old = dwindow_set((struct dwindow){x, y, x + 13, y + 13});
+	draw_static(x, y, 13, 13);
+	draw_board(row - 1, row + 1, col - 1, col + 1);
+	dwindow_set(old);
+}
+
+/* Whether a region differs from either of the last two frames drawn */
+static bool is_dirty(const void *now, const void *last1, const void *last2,
+	size_t size)
+{
+	return memcmp(now, last1, size) || memcmp(now, last2, size);
+}
+
+void display_game()
+{
+	TRACE_ADD(TRACE_DISPLAY, TRACE_BEGIN);
+
+	// Prepare gray engine
+	display_init_gray();
+
+	// The gray engine draws into alternating buffers, so a region is only
+	// up to date if it matches both of the frames drawn before this one
+	frame_t *last1 = &frames[frame_i ^ 1];
+	frame_t *last2 = &frames[frame_i];
+	board_scroll(&view);
+	board_frame(&view, &current);
+
+	if (!is_static_valid())
+		frames_valid = 0;
+
+	if (debug_display || frames_valid < 2) {
+		// Draw everything
+		timing_enter(TIMING_BACKGROUND);
+		if (!is_static_valid()) {
+			build_static();
+		} else {
+			uint32_t *light, *dark;
+			dgray_getvram(&light, &dark);
+			memcpy(light, static_layer[0], sizeof(static_layer[0]));
+			memcpy(dark, static_layer[1], sizeof(static_layer[1]));
+		}
+		timing_leave(TIMING_BACKGROUND);
+		draw_board(view.row, view.row + view.rows - 1, view.col,
+			view.col + view.cols - 1);
+		draw_header();
+	} else {
+		// Redraw only the cells and header that changed
+		int dirty = 0;
+		for (int row = view.row; row < view.row + view.rows; ++row)
+			for (int col = view.col; col < view.col + view.cols;
+					++col) {
+				int i = GRID_WIDTH * row + col;
+				if (!is_dirty(&current.cells[i], &last1->cells[i],
+						&last2->cells[i],
+						sizeof(cell_state_t)))
+					continue;
+				redraw_cell(row, col);
+				++dirty;
+			}
+		if (is_dirty(&current.header, &last1->header, &last2->header,
+				sizeof(header_state_t))) {
+			struct dwindow old = dwindow_set((struct dwindow){
+				HEADER_LEFT, 0, DWIDTH, DHEIGHT});
+			draw_static(HEADER_LEFT, 0, DWIDTH - HEADER_LEFT,
+				DHEIGHT);
+			draw_header();
+			dwindow_set(old);
+			++dirty;
+		}
 
-	// Draw laser beam
-	draw_laser();
+		// Both buffers already show this frame
+		if (!dirty) {
+			timing_frame();
+			TRACE_ADD(TRACE_DISPLAY, TRACE_END);
+			return;
+		}
+	}
+	*last2 = current;
+	frame_i ^= 1;
+	if (debug_display)
+		frames_valid = 0;
+	else if (frames_valid < 2)
+		++frames_valid;
 
 	// Draw VRAM to display
+	timing_frame();
+	debug();
+	timing_enter(TIMING_UPDATE);
+	dupdate();
+	timing_leave(TIMING_UPDATE);
+	TRACE_ADD(TRACE_DISPLAY, TRACE_END);
+}
+
+/* Draws everything on the next display_game() */
+void display_invalidate(void)
+{
+	frames_valid = 0;
+}
+
+/* The whole board, zoomed out, with the viewport outlined */
+void display_overview(void)
+{
+	display_init_gray();
+	frames_valid = 0;
+	board_frame(&view, &current);
+	dclear(C_WHITE);
+	dprint(2, 2, C_BLACK, "OVERVIEW");
+
+	int size = OVERVIEW_CELL;
+	int left = (DWIDTH - size * GRID_WIDTH) / 2;
+	int top = (DHEIGHT - size * GRID_HEIGHT) / 2 + 4;
+	drect(left - 1, top - 1, left + size * GRID_WIDTH,
+		top + size * GRID_HEIGHT, C_BLACK);
+	drect(left, top, left + size * GRID_WIDTH - 1,
+		top + size * GRID_HEIGHT - 1, C_WHITE);
+	for (int row = 0; row < GRID_HEIGHT; ++row)
+		for (int col = 0; col < GRID_WIDTH; ++col) {
+			int x = left + size * col;
+			int y = top + size * row;
+			token_t *token = game_get_token(row, col);
+			int color = C_NONE;
+			if (token->type != TOKEN_NONE)
+				color = board_is_static(token) ? C_DARK : C_BLACK;
+			else if (current.cells[GRID_WIDTH * row + col].beam)
+				color = C_LIGHT;
+			if (color != C_NONE)
+				drect(x + 1, y + 1, x + size - 2, y + size - 2,
+					color);
+			if (game_is_cursor(row, col))
+				drect(x, y, x + size - 1, y + size - 1,
+					C_INVERT);
+		}
+	int x = left + size * view.col;
+	int y = top + size * view.row;
+	draw_frame(x - 1, y - 1, x + size * view.cols, y + size * view.rows,
+		C_LIGHT);
 	debug();
 	dupdate();
 }
@@ -458,7 +526,9 @@ void display_game()
 void display_help1()
 {
 	display_init_gray();
-	dimage(0, 0, (gint[HWCALC] == HWCALC_FXCG100) ? &img_help1_cg100 : &img_help1);
+	frames_valid = 0;
+	sprite_draw((gint[HWCALC] == HWCALC_FXCG100) ? &sprite_help1_cg100 :
+		&sprite_help1, 0, 0, sprite_run);
 	debug();
 	dupdate();
 }
@@ -466,6 +536,7 @@ void display_help1()
 void display_help2()
 {
 	display_init_gray();
+	frames_valid = 0;
 	dclear(C_WHITE);
 	dprint(2, 2, C_BLACK, "HOW TO PLAY");
 	dline(2, 8, 41, 8, C_BLACK);
@@ -475,14 +546,120 @@ void display_help2()
 	dprint(1, 32, C_BLACK, "*HIT THE INDICATED # OF TARGETS,");
 	dprint(5, 38, C_BLACK, "INCLUDING ALL REQUIRED TARGETS.");
 	dprint(1, 46, C_BLACK, "*USE EVERY TOKEN (BLOCK EXCEPTED).");
-	dimage(0, 55, (gint[HWCALC] == HWCALC_FXCG100) ? &img_help2_cg100 : &img_help2);
+	sprite_draw((gint[HWCALC] == HWCALC_FXCG100) ? &sprite_help2_cg100 :
+		&sprite_help2, 0, 55, sprite_run);
+	dupdate();
+}
+
+void display_packs(int sel)
+{
+	display_init_gray();
+	frames_valid = 0;
+	dclear(C_WHITE);
+	dprint(2, 2, C_BLACK, "PUZZLE PACKS");
+	dline(2, 8, 49, 8, C_BLACK);
+
+	int first = sel - PACK_ROWS + 1;
+	if (first < 0)
+		first = 0;
+	for (int i = first; i < library_count() && i < first + PACK_ROWS; ++i) {
+		pack_t *pack = library_get(i);
+		int y = 7 * (i - first) + 12;
+		if (i == sel)
+			drect(0, y - 1, 127, y + 5, C_LIGHT);
+		dprint(2, y, C_BLACK, "%s", pack->title);
+		dprint_opt(126, y, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP,
+			"%i/%i", pack->solved, pack->puzzles);
+	}
+	debug();
+	dupdate();
+}
+
+/* Copies a thumbnail into VRAM */
+static void draw_thumb(int x, int y, const thumb_t *thumb)
+{
+	uint32_t *planes[2];
+	dgray_getvram(&planes[0], &planes[1]);
+	int word = x / 32;
+	int shift = 48 - (x & 31);
+	uint64_t mask = (uint64_t)0xffff << shift;
+	for (int plane = 0; plane < 2; ++plane)
+		for (int row = 0; row < THUMB_SIZE; ++row) {
+			uint32_t *dst = &planes[plane][ROW_WORDS * (y + row) + word];
+			uint64_t bits = (uint64_t)thumb->planes[plane][row] << shift;
+			dst[0] = (dst[0] & ~(uint32_t)(mask >> 32)) | (bits >> 32);
+			if (word + 1 < ROW_WORDS)
+				dst[1] = (dst[1] & ~(uint32_t)mask) | (uint32_t)bits;
+		}
+}
+
+void display_levels(int sel)
+{
+	display_init_gray();
+	frames_valid = 0;
+	dclear(C_WHITE);
+	dprint(2, 2, C_BLACK, "PUZZLES");
+	dline(2, 8, 49, 8, C_BLACK);
+	dprint_opt(126, 2, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, "%i/%i",
+		sel + 1, game_get_puzzle_count());
+
+	// Scroll by whole rows to keep the selection on screen
+	int row = sel / THUMB_COLS;
+	int first = THUMB_COLS * (row < THUMB_ROWS ? 0 : row - THUMB_ROWS + 1);
+	char *solved = game_get_solved();
+	for (int i = first; i < game_get_puzzle_count() &&
+			i < first + THUMB_COLS * THUMB_ROWS; ++i) {
+		int x = 18 * ((i - first) % THUMB_COLS) + 2;
+		int y = 18 * ((i - first) / THUMB_COLS) + 10;
+		draw_thumb(x, y, board_thumb(i));
+		if (solved[i] == '1')
+			draw_frame(x, y, x + THUMB_SIZE - 1, y + THUMB_SIZE - 1,
+				C_BLACK);
+		if (i == sel)
+			draw_frame(x - 1, y - 1, x + THUMB_SIZE, y + THUMB_SIZE,
+				C_BLACK);
+	}
+	debug();
+	dupdate();
+}
+
+static void draw_bench_row(int y, const char *name, uint32_t avg,
+				uint32_t max)
+{
+	dprint(2, y, C_BLACK, "%s", name);
+	dprint_opt(90, y, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, "%lu.%lu",
+		(unsigned long)avg / 1000, (unsigned long)avg / 100 % 10);
+	dprint_opt(126, y, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, "%lu.%lu",
+		(unsigned long)max / 1000, (unsigned long)max / 100 % 10);
+}
+
+void display_bench(const bench_t *bench)
+{
+	display_init_gray();
+	frames_valid = 0;
+	dclear(C_WHITE);
+	dprint(2, 2, C_BLACK, "BENCHMARK");
+	dline(2, 8, 49, 8, C_BLACK);
+	dprint(2, 12, C_BLACK, "%i PUZZLES, %i RUNS", bench->puzzles,
+		BENCH_ITERATIONS);
+	dprint_opt(90, 20, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, "AVG US");
+	dprint_opt(126, 20, C_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, "MAX US");
+	draw_bench_row(27, "LOAD", bench->avg.load, bench->max.load);
+	draw_bench_row(34, "LASER", bench->avg.laser, bench->max.laser);
+	draw_bench_row(41, "DRAW", bench->avg.display, bench->max.display);
+	draw_bench_row(48, "CHECK MS", bench->avg.check, bench->max.check);
+	dprint(2, 57, C_BLACK, bench->sent ? "CSV SENT OVER USB" :
+		"USB NOT CONNECTED");
 	dupdate();
 }
 
 void display_file_error(int rc, const char *op, const char *filename)
 {
 	dgray(DGRAY_OFF);
+	TRACE_ADD(TRACE_GRAY_OFF, TRACE_INSTANT);
 	dfont(NULL);
+	mode = MODE_NONE;
+	frames_valid = 0;
 	dclear(C_WHITE);
 	dprint(0, 0, C_BLACK, "Error %i %s", rc, op);
 	dprint(0, 8, C_BLACK, "%s", filename);
@@ -492,5 +669,5 @@ void display_file_error(int rc, const char *op, const char *filename)
 
 bool display_is_using_gray_engine(void)
 {
-	return display_is_gray;
+	return mode == MODE_GRAY;
 }
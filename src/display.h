@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022, 2025  Jeffry Johnston
+Copyright (C) 2022, 2025, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -21,12 +21,21 @@ along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <stdbool.h>
+#include "bench.h"
+
+// Puzzles per row on the level select screen
+#define THUMB_COLS 7
 
 void display_init(void);
 void display_init_mono(const bool clear);
 void display_menu_return(void);
 void display_game(void);
+void display_invalidate(void);
+void display_overview(void);
 void display_help1(void);
 void display_help2(void);
+void display_packs(int sel);
+void display_levels(int sel);
+void display_bench(const bench_t *bench);
 void display_file_error(int rc, const char *op, const char *filename);
 bool display_is_using_gray_engine(void);
@@ -0,0 +1,699 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Native fx-CG renderer, built instead of display.c by the cg target. Screens
+keep the layout of the 128x64 fx screens, scaled up 3 times and centered on
+the 396x224 RGB565 display, so coordinates below are fx pixels.
+
+Images are the fx assets converted to 4-bit palette images. blit() scales
+them while mapping each palette entry to a gray level and each gray level to
+a colour through lookup tables. The board is drawn straight into a single
+VRAM, only cells that changed are redrawn, and only the rows touched are sent
+to the display.
+*/
+
+#include <gint/display.h>
+#include <gint/drivers/r61524.h>
+#include <gint/gint.h>
+#include <gint/hardware.h>
+#include <gint/image.h>
+#include <string.h>
+#include "board.h"
+#include "display.h"
+#include "editor.h"
+#include "game.h"
+#include "library.h"
+#include "record.h"
+#include "sprite.h"
+#include "timing.h"
+#include "trace.h"
+
+#define SCALE 3
+#define SCREEN_LEFT ((DWIDTH - SCALE * 128) / 2)
+#define SCREEN_TOP ((DHEIGHT - SCALE * 64) / 2)
+
+#define PACK_ROWS 7
+#define THUMB_ROWS 3
+
+#define HEADER_LEFT 94
+#define VIEW_ROWS (GRID_HEIGHT < 5 ? GRID_HEIGHT : 5)
+#define VIEW_COLS (GRID_WIDTH < 5 ? GRID_WIDTH : 5)
+#define OVERVIEW_CELL 6
+
+#define GLYPH_SIZE 13
+#define TOKEN_SIZE 11
+
+// Gray levels, matching the fx gray planes: bit 0 light, bit 1 dark
+#define GRAY_WHITE 0
+#define GRAY_LIGHT 1
+#define GRAY_DARK 2
+#define GRAY_BLACK 3
+
+typedef struct {
+	int left;
+	int top;
+	int right;
+	int bottom;
+} rect_t;
+
+extern image_t img_background;
+extern image_t img_background_cg100;
+extern image_t img_beam;
+extern image_t img_cursor;
+extern image_t img_selection;
+extern image_t img_solved;
+extern image_t img_target_hit;
+extern image_t img_target_missed;
+extern image_t img_tokens;
+
+uint8_t debug_display = 0;
+uint8_t debug_r;
+uint8_t debug_g;
+uint8_t debug_b;
+
+static uint16_t colors[4];
+
+// Drawing is clipped to this rectangle, right and bottom exclusive
+static rect_t clip = {0, 0, 128, 64};
+
+// Display rows drawn since the last update
+static int changed_top = DHEIGHT;
+static int changed_bottom;
+
+// The last frame drawn, which VRAM still holds
+static frame_t last;
+static int last_valid;
+static int last_load = -1;
+static view_t last_view;
+
+// Board cells on screen, and what they show in the frame being drawn
+static view_t view = {0, 0, VIEW_ROWS, VIEW_COLS};
+static frame_t current;
+
+static int sx(int x)
+{
+	return SCREEN_LEFT + SCALE * x;
+}
+
+static int sy(int y)
+{
+	return SCREEN_TOP + SCALE * y;
+}
+
+static void set_clip(int left, int top, int right, int bottom)
+{
+	clip = (rect_t){left, top, right, bottom};
+}
+
+static void changed(int top, int bottom)
+{
+	if (sy(top) < changed_top)
+		changed_top = sy(top);
+	if (sy(bottom) > changed_bottom)
+		changed_bottom = sy(bottom);
+}
+
+static void changed_all(void)
+{
+	changed_top = 0;
+	changed_bottom = DHEIGHT;
+}
+
+/* Sends the rows drawn since the last update to the display */
+static void update(void)
+{
+	timing_enter(TIMING_UPDATE);
+	if (changed_top < changed_bottom)
+		r61524_display(gint_vram, changed_top,
+			changed_bottom - changed_top, R61524_DMA_WAIT);
+	changed_top = DHEIGHT;
+	changed_bottom = 0;
+	timing_leave(TIMING_UPDATE);
+}
+
+static void update_colors(void)
+{
+	colors[GRAY_WHITE] = C_WHITE;
+	colors[GRAY_LIGHT] = (debug_r << 11) | (debug_g << 5) | debug_b;
+	colors[GRAY_DARK] = C_DARK;
+	colors[GRAY_BLACK] = C_BLACK;
+}
+
+/* Gray level of an RGB565 palette entry, from its luminance */
+static int gray_level(uint16_t color)
+{
+	int luma = 2 * (color >> 11) + ((color >> 5) & 0x3f) +
+		2 * (color & 0x1f);
+	return GRAY_BLACK - (luma + 31) / 62;
+}
+
+/* Fills a rectangle, inclusive, with a gray level */
+static void fill(int x1, int y1, int x2, int y2, int level)
+{
+	if (x1 < clip.left)
+		x1 = clip.left;
+	if (y1 < clip.top)
+		y1 = clip.top;
+	if (x2 >= clip.right)
+		x2 = clip.right - 1;
+	if (y2 >= clip.bottom)
+		y2 = clip.bottom - 1;
+	if (x1 > x2 || y1 > y2)
+		return;
+	drect(sx(x1), sy(y1), sx(x2 + 1) - 1, sy(y2 + 1) - 1, colors[level]);
+	changed(y1, y2 + 1);
+}
+
+static void frame_rect(int x1, int y1, int x2, int y2, int level)
+{
+	fill(x1, y1, x2, y1, level);
+	fill(x1, y2, x2, y2, level);
+	fill(x1, y1, x1, y2, level);
+	fill(x2, y1, x2, y2, level);
+}
+
+static void clear(void)
+{
+	set_clip(0, 0, 128, 64);
+	dclear(colors[GRAY_WHITE]);
+	changed_all();
+}
+
+/*
+Draws part of a 4-bit palette image scaled up. Palette index 0 is transparent.
+Each source row is expanded once into a scaled row of colours, then copied to
+as many display rows.
+*/
+static void blit(int x, int y, const image_t *img, int left, int top, int w,
+	int h)
+{
+	uint16_t lut[16];
+	for (int i = 1; i < 16 && i < img->color_count; ++i)
+		lut[i] = colors[gray_level(img->palette[i])];
+
+	// Clip in fx pixels
+	if (x < clip.left) {
+		left += clip.left - x;
+		w -= clip.left - x;
+		x = clip.left;
+	}
+	if (y < clip.top) {
+		top += clip.top - y;
+		h -= clip.top - y;
+		y = clip.top;
+	}
+	if (x + w > clip.right)
+		w = clip.right - x;
+	if (y + h > clip.bottom)
+		h = clip.bottom - y;
+	if (w <= 0 || h <= 0)
+		return;
+
+	uint16_t line[SCALE * 128];
+	uint8_t mask[SCALE * 128];
+	for (int row = 0; row < h; ++row) {
+		const uint8_t *src = (const uint8_t *)img->data +
+			img->stride * (top + row);
+		for (int col = 0; col < w; ++col) {
+			int px = left + col;
+			int index = (src[px >> 1] >> ((px & 1) ? 0 : 4)) & 0x0f;
+			for (int i = SCALE * col; i < SCALE * (col + 1); ++i) {
+				line[i] = lut[index];
+				mask[i] = index;
+			}
+		}
+		uint16_t *dst = gint_vram + DWIDTH * sy(y + row) + sx(x);
+		for (int i = 0; i < SCALE; ++i, dst += DWIDTH)
+			for (int j = 0; j < SCALE * w; ++j)
+				if (mask[j])
+					dst[j] = line[j];
+	}
+	changed(y, y + h);
+}
+
+static void image(int x, int y, const image_t *img)
+{
+	blit(x, y, img, 0, 0, img->width, img->height);
+}
+
+static void text(int x, int y, int level, int halign, const char *str)
+{
+	dtext_opt(sx(x), sy(y), colors[level], C_NONE, halign, DTEXT_TOP, str,
+		-1);
+	changed(y, y + 6);
+}
+
+static const image_t *background(void)
+{
+	return (gint[HWCALC] == HWCALC_FXCG100) ? &img_background_cg100 :
+		&img_background;
+}
+
+void display_init(void)
+{
+	board_init();
+	debug_r = 28;
+	debug_g = 0;
+	debug_b = 5;
+	update_colors();
+}
+
+void display_init_mono(const bool clear_screen)
+{
+	update_colors();
+	if (clear_screen)
+		clear();
+	last_valid = 0;
+}
+
+static void sprite_run(int x1, int x2, int y, int level)
+{
+	fill(x1, y, x2, y, level);
+}
+
+void display_menu_return(void)
+{
+	display_init_mono(true);
+	sprite_draw(&sprite_logo, 24, 13, sprite_run);
+	text(20, 45, GRAY_BLACK, DTEXT_LEFT, "PRESS ANY KEY TO CONTINUE");
+	update();
+}
+
+static void debug(void)
+{
+	if (!debug_display)
+		return;
+
+	set_clip(0, 0, 128, 64);
+	fill(95, 37, 127, 63, GRAY_DARK);
+	text(96, 38, GRAY_WHITE, DTEXT_LEFT, "RGB565");
+	text(96, 52, GRAY_WHITE, DTEXT_LEFT, "R");
+	text(107, 52, GRAY_WHITE, DTEXT_LEFT, "G");
+	text(118, 52, GRAY_WHITE, DTEXT_LEFT, "B");
+	dprint(sx(96), sy(44), colors[GRAY_WHITE], "%04X", colors[GRAY_LIGHT]);
+	dprint(sx(96), sy(58), colors[GRAY_WHITE], "%u", debug_r);
+	dprint(sx(107), sy(58), colors[GRAY_WHITE], "%u", debug_g);
+	dprint(sx(118), sy(58), colors[GRAY_WHITE], "%u", debug_b);
+
+	// Frame time breakdown in microseconds, or milliseconds with an M
+	static const char *names[TIMING_COUNT] = {"KEY", "LSR", "BKG", "TOK",
+						"BEAM", "UPD"};
+	fill(0, 19, 94, 62, GRAY_WHITE);
+	text(1, 20, GRAY_BLACK, DTEXT_LEFT, "US");
+	text(45, 20, GRAY_BLACK, DTEXT_RIGHT, "MIN");
+	text(69, 20, GRAY_BLACK, DTEXT_RIGHT, "AVG");
+	text(93, 20, GRAY_BLACK, DTEXT_RIGHT, "MAX");
+	for (int t = 0; t < TIMING_COUNT; ++t) {
+		uint32_t times[3];
+		timing_get(t, &times[0], &times[1], &times[2]);
+		int y = 6 * t + 27;
+		text(1, y, GRAY_BLACK, DTEXT_LEFT, names[t]);
+		for (int i = 0; i < 3; ++i)
+			dprint_opt(sx(24 * i + 45), sy(y), colors[GRAY_BLACK],
+				C_NONE, DTEXT_RIGHT, DTEXT_TOP,
+				times[i] < 10000 ? "%u" : "%uM",
+				(unsigned int)(times[i] < 10000 ? times[i] :
+					times[i] / 1000));
+	}
+	changed(19, 64);
+}
+
+/* Left and top of a cell box */
+static int cell_x(int col)
+{
+	return 12 * (col - view.col) + 33;
+}
+
+static int cell_y(int row)
+{
+	return 12 * (row - view.row) + 1;
+}
+
+/* Draws the beam paths through a cell, from the frame being drawn */
+static void draw_beam(int row, int col)
+{
+	uint32_t beam = current.cells[GRID_WIDTH * row + col].beam;
+	if (!beam)
+		return;
+	token_t *token = game_get_token(row, col);
+	for (int i = 0; beam; ++i, beam >>= 1) {
+		if (!(beam & 0x01))
+			continue;
+		path_t path = {row, col, i / 5, i % 5};
+		int glyph = board_glyph(&path, token);
+		if (glyph >= 0)
+			blit(cell_x(col), cell_y(row), &img_beam,
+				GLYPH_SIZE * glyph, 0, GLYPH_SIZE, GLYPH_SIZE);
+	}
+}
+
+static void draw_token(int row, int col)
+{
+	int y = cell_y(row) + 1;
+	int x = cell_x(col) + 1;
+	int sprite = board_sprite(game_get_token(row, col));
+	if (sprite >= 0)
+		blit(x, y, &img_tokens, TOKEN_SIZE * sprite, 0, TOKEN_SIZE,
+			TOKEN_SIZE);
+
+	if (game_is_selection(row, col))
+		image(x - 1, y - 1, &img_selection);
+	else if (game_is_cursor(row, col))
+		image(x - 1, y - 1, &img_cursor);
+	else if (game_is_preview(row, col))
+		frame_rect(x + 1, y + 1, x + 9, y + 9, GRAY_LIGHT);
+}
+
+/* Draws the background, then the tokens and beams, culled to the view */
+static void draw_board(int row1, int row2, int col1, int col2)
+{
+	if (row1 < view.row)
+		row1 = view.row;
+	if (row2 > view.row + view.rows - 1)
+		row2 = view.row + view.rows - 1;
+	if (col1 < view.col)
+		col1 = view.col;
+	if (col2 > view.col + view.cols - 1)
+		col2 = view.col + view.cols - 1;
+
+	timing_enter(TIMING_BACKGROUND);
+	blit(clip.left, clip.top, background(), clip.left, clip.top,
+		clip.right - clip.left, clip.bottom - clip.top);
+	timing_leave(TIMING_BACKGROUND);
+	timing_enter(TIMING_TOKENS);
+	for (int row = row1; row <= row2; ++row)
+		for (int col = col1; col <= col2; ++col)
+			draw_token(row, col);
+	timing_leave(TIMING_TOKENS);
+	timing_enter(TIMING_BEAM);
+	for (int row = row1; row <= row2; ++row)
+		for (int col = col1; col <= col2; ++col)
+			draw_beam(row, col);
+	timing_leave(TIMING_BEAM);
+}
+
+static void draw_header(void)
+{
+	// Draw puzzle ID, target completion, and solve/win status
+	set_clip(HEADER_LEFT, 0, 128, 64);
+	blit(HEADER_LEFT, 0, background(), HEADER_LEFT, 0, 128 - HEADER_LEFT,
+		64);
+	dprint(sx(114), sy(1), colors[GRAY_BLACK], "%i",
+		game_get_puzzle_id());
+	for (int i = 0; i < get_targets_req(); ++i) {
+		const image_t *img = i < get_targets_hit() ? &img_target_hit :
+							&img_target_missed;
+		image(8 * i + 100, 9, img);
+	}
+	if (game_is_solved())
+		image(101, 1, &img_solved);
+	if (game_is_total_winner())
+		text(98, 29, GRAY_LIGHT, DTEXT_LEFT, "YOU WIN!");
+	if (record_is_on())
+		text(98, 57, GRAY_BLACK, DTEXT_LEFT,
+			record_is_full() ? "FULL" : "REC");
+	if (editor_label())
+		text(98, 49, GRAY_BLACK, DTEXT_LEFT, editor_label());
+}
+
+/* Redraws a cell box. Boxes share their edges, so the neighbors are drawn too,
+clipped to the box. */
+static void redraw_cell(int row, int col)
+{
+	int x = cell_x(col);
+	int y = cell_y(row);
+	set_clip(x, y, x + 13, y + 13);
+	draw_board(row - 1, row + 1, col - 1, col + 1);
+}
+
+void display_game()
+{
+	TRACE_ADD(TRACE_DISPLAY, TRACE_BEGIN);
+	update_colors();
+	board_scroll(&view);
+	board_frame(&view, &current);
+
+	if (debug_display || !last_valid ||
+			last_load != game_get_load_count() ||
+			last_view.row != view.row || last_view.col != view.col) {
+		// Draw everything
+		clear();
+		set_clip(0, 0, HEADER_LEFT, 64);
+		draw_board(view.row, view.row + view.rows - 1, view.col,
+			view.col + view.cols - 1);
+		draw_header();
+	} else {
+		// Redraw only the cells and header that changed
+		for (int row = view.row; row < view.row + view.rows; ++row)
+			for (int col = view.col; col < view.col + view.cols;
+					++col) {
+				int i = GRID_WIDTH * row + col;
+				if (memcmp(&current.cells[i], &last.cells[i],
+						sizeof(cell_state_t)))
+					redraw_cell(row, col);
+			}
+		if (memcmp(&current.header, &last.header,
+				sizeof(header_state_t)))
+			draw_header();
+
+		// The display already shows this frame
+		if (changed_top >= changed_bottom) {
+			timing_frame();
+			TRACE_ADD(TRACE_DISPLAY, TRACE_END);
+			return;
+		}
+	}
+	last = current;
+	last_valid = !debug_display;
+	last_load = game_get_load_count();
+	last_view = view;
+
+	timing_frame();
+	debug();
+	update();
+	TRACE_ADD(TRACE_DISPLAY, TRACE_END);
+}
+
+/* Draws everything on the next display_game() */
+void display_invalidate(void)
+{
+	last_valid = 0;
+}
+
+/* The whole board, zoomed out, with the viewport outlined */
+void display_overview(void)
+{
+	update_colors();
+	last_valid = 0;
+	board_frame(&view, &current);
+	clear();
+	text(2, 2, GRAY_BLACK, DTEXT_LEFT, "OVERVIEW");
+
+	int size = OVERVIEW_CELL;
+	int left = (128 - size * GRID_WIDTH) / 2;
+	int top = (64 - size * GRID_HEIGHT) / 2 + 4;
+	frame_rect(left - 1, top - 1, left + size * GRID_WIDTH,
+		top + size * GRID_HEIGHT, GRAY_BLACK);
+	for (int row = 0; row < GRID_HEIGHT; ++row)
+		for (int col = 0; col < GRID_WIDTH; ++col) {
+			int x = left + size * col;
+			int y = top + size * row;
+			token_t *token = game_get_token(row, col);
+			int level = GRAY_WHITE;
+			if (token->type != TOKEN_NONE)
+				level = board_is_static(token) ? GRAY_DARK :
+					GRAY_BLACK;
+			else if (current.cells[GRID_WIDTH * row + col].beam)
+				level = GRAY_LIGHT;
+			if (level != GRAY_WHITE)
+				fill(x + 1, y + 1, x + size - 2, y + size - 2,
+					level);
+			if (game_is_cursor(row, col))
+				frame_rect(x, y, x + size - 1, y + size - 1,
+					GRAY_LIGHT);
+		}
+	int x = left + size * view.col;
+	int y = top + size * view.row;
+	frame_rect(x - 1, y - 1, x + size * view.cols, y + size * view.rows,
+		GRAY_LIGHT);
+	debug();
+	update();
+}
+
+void display_help1()
+{
+	update_colors();
+	last_valid = 0;
+	clear();
+	sprite_draw((gint[HWCALC] == HWCALC_FXCG100) ? &sprite_help1_cg100 :
+		&sprite_help1, 0, 0, sprite_run);
+	debug();
+	update();
+}
+
+void display_help2()
+{
+	update_colors();
+	last_valid = 0;
+	clear();
+	text(2, 2, GRAY_BLACK, DTEXT_LEFT, "HOW TO PLAY");
+	fill(2, 8, 41, 8, GRAY_BLACK);
+	text(1, 12, GRAY_BLACK, DTEXT_LEFT,
+		"*MOVE/ROTATE TOKENS TO HIT TARGETS;");
+	text(5, 18, GRAY_BLACK, DTEXT_LEFT,
+		"TARGETS LIGHT UP WHEN HIT. NOT ALL");
+	text(5, 24, GRAY_BLACK, DTEXT_LEFT, "TOKENS CAN MOVE/ROTATE.");
+	text(1, 32, GRAY_BLACK, DTEXT_LEFT,
+		"*HIT THE INDICATED # OF TARGETS,");
+	text(5, 38, GRAY_BLACK, DTEXT_LEFT, "INCLUDING ALL REQUIRED TARGETS.");
+	text(1, 46, GRAY_BLACK, DTEXT_LEFT,
+		"*USE EVERY TOKEN (BLOCK EXCEPTED).");
+	sprite_draw((gint[HWCALC] == HWCALC_FXCG100) ? &sprite_help2_cg100 :
+		&sprite_help2, 0, 55, sprite_run);
+	update();
+}
+
+void display_packs(int sel)
+{
+	update_colors();
+	last_valid = 0;
+	clear();
+	text(2, 2, GRAY_BLACK, DTEXT_LEFT, "PUZZLE PACKS");
+	fill(2, 8, 49, 8, GRAY_BLACK);
+
+	int first = sel - PACK_ROWS + 1;
+	if (first < 0)
+		first = 0;
+	for (int i = first; i < library_count() && i < first + PACK_ROWS; ++i) {
+		pack_t *pack = library_get(i);
+		int y = 7 * (i - first) + 12;
+		if (i == sel)
+			fill(0, y - 1, 127, y + 5, GRAY_LIGHT);
+		text(2, y, GRAY_BLACK, DTEXT_LEFT, pack->title);
+		dprint_opt(sx(126), sy(y), colors[GRAY_BLACK], C_NONE,
+			DTEXT_RIGHT, DTEXT_TOP, "%i/%i", pack->solved,
+			pack->puzzles);
+	}
+	debug();
+	update();
+}
+
+/* Draws a thumbnail, one fill per run of pixels of the same gray level */
+static void draw_thumb(int x, int y, const thumb_t *thumb)
+{
+	for (int row = 0; row < THUMB_SIZE; ++row) {
+		int start = 0;
+		int level = GRAY_WHITE;
+		for (int col = 0; col <= THUMB_SIZE; ++col) {
+			int next = -1;
+			if (col < THUMB_SIZE) {
+				uint16_t bit = 0x8000 >> col;
+				next = ((thumb->planes[0][row] & bit) ? 1 : 0) |
+					((thumb->planes[1][row] & bit) ? 2 : 0);
+			}
+			if (next == level)
+				continue;
+			if (level != GRAY_WHITE)
+				fill(x + start, y + row, x + col - 1, y + row,
+					level);
+			start = col;
+			level = next;
+		}
+	}
+}
+
+void display_levels(int sel)
+{
+	update_colors();
+	last_valid = 0;
+	clear();
+	text(2, 2, GRAY_BLACK, DTEXT_LEFT, "PUZZLES");
+	fill(2, 8, 49, 8, GRAY_BLACK);
+	dprint_opt(sx(126), sy(2), colors[GRAY_BLACK], C_NONE, DTEXT_RIGHT,
+		DTEXT_TOP, "%i/%i", sel + 1, game_get_puzzle_count());
+
+	// Scroll by whole rows to keep the selection on screen
+	int row = sel / THUMB_COLS;
+	int first = THUMB_COLS * (row < THUMB_ROWS ? 0 : row - THUMB_ROWS + 1);
+	char *solved = game_get_solved();
+	for (int i = first; i < game_get_puzzle_count() &&
+			i < first + THUMB_COLS * THUMB_ROWS; ++i) {
+		int x = 18 * ((i - first) % THUMB_COLS) + 2;
+		int y = 18 * ((i - first) / THUMB_COLS) + 10;
+		draw_thumb(x, y, board_thumb(i));
+		if (solved[i] == '1')
+			frame_rect(x, y, x + THUMB_SIZE - 1,
+				y + THUMB_SIZE - 1, GRAY_BLACK);
+		if (i == sel)
+			frame_rect(x - 1, y - 1, x + THUMB_SIZE,
+				y + THUMB_SIZE, GRAY_BLACK);
+	}
+	debug();
+	update();
+}
+
+static void draw_bench_row(int y, const char *name, uint32_t avg,
+				uint32_t max)
+{
+	text(2, y, GRAY_BLACK, DTEXT_LEFT, name);
+	dprint_opt(sx(90), sy(y), colors[GRAY_BLACK], C_NONE, DTEXT_RIGHT,
+		DTEXT_TOP, "%lu.%lu", (unsigned long)avg / 1000,
+		(unsigned long)avg / 100 % 10);
+	dprint_opt(sx(126), sy(y), colors[GRAY_BLACK], C_NONE, DTEXT_RIGHT,
+		DTEXT_TOP, "%lu.%lu", (unsigned long)max / 1000,
+		(unsigned long)max / 100 % 10);
+}
+
+void display_bench(const bench_t *bench)
+{
+	update_colors();
+	last_valid = 0;
+	clear();
+	text(2, 2, GRAY_BLACK, DTEXT_LEFT, "BENCHMARK");
+	fill(2, 8, 49, 8, GRAY_BLACK);
+	dprint(sx(2), sy(12), colors[GRAY_BLACK], "%i PUZZLES, %i RUNS",
+		bench->puzzles, BENCH_ITERATIONS);
+	text(90, 20, GRAY_BLACK, DTEXT_RIGHT, "AVG US");
+	text(126, 20, GRAY_BLACK, DTEXT_RIGHT, "MAX US");
+	draw_bench_row(27, "LOAD", bench->avg.load, bench->max.load);
+	draw_bench_row(34, "LASER", bench->avg.laser, bench->max.laser);
+	draw_bench_row(41, "DRAW", bench->avg.display, bench->max.display);
+	draw_bench_row(48, "CHECK MS", bench->avg.check, bench->max.check);
+	text(2, 57, GRAY_BLACK, DTEXT_LEFT, bench->sent ?
+		"CSV SENT OVER USB" : "USB NOT CONNECTED");
+	update();
+}
+
+void display_file_error(int rc, const char *op, const char *filename)
+{
+	update_colors();
+	last_valid = 0;
+	clear();
+	dprint(sx(0), sy(0), colors[GRAY_BLACK], "Error %i %s", rc, op);
+	text(0, 8, GRAY_BLACK, DTEXT_LEFT, filename);
+	text(0, 28, GRAY_BLACK, DTEXT_LEFT, "Press any key to exit");
+	update();
+}
+
+bool display_is_using_gray_engine(void)
+{
+	return false;
+}
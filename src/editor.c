@@ -0,0 +1,254 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Puzzle editor. The puzzle is edited in place by the game_edit_*() functions,
+and after each change, the solver runs again as an idle task to find out
+whether the puzzle has no solution, one, or several. It stops at the second
+solution, but telling one solution from none takes a full search: up to
+about 120000 traces for a puzzle with five movable tokens, 33 to 47 ms on a
+PC and likely seconds on a calculator, where bench_run() times it. Most
+edits need no search, though: the solutions found for the last layout often
+still solve the new one once their tokens are moved onto it, at one trace
+each. Two that do give the count at once, and one shows EDIT 1+ until the
+solver finds the second or rules it out; so does the first solution the
+solver finds. The search gives up after EDITOR_TRACES traces, leaving EDIT
+1+ or EDIT 0? for a count it could not settle. The last few layouts checked
+are remembered, so that taking a change back shows its result at once. A
+timer redraws the screen once the result changes. A save that
+game_edit_save() rejects, or that cannot reach storage because the pack
+came over USB, shows NO SAVE until the next change.
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "editor.h"
+#include "solver.h"
+
+#define KEY_BYTES (GRID_SIZE + 1)
+
+typedef struct {
+	uint8_t key[KEY_BYTES];
+	uint8_t result;
+} checked_t;
+
+static editor_result_t result;
+static int solutions;
+static int searching;
+static int finished;
+static int save_error;
+static uint8_t key[KEY_BYTES];
+static checked_t checked[EDITOR_CHECKED];
+static int checked_next;
+static token_t found[2][GRID_SIZE];
+static int found_count;
+
+static const char *labels[] = {
+	NULL, "EDIT ?", "EDIT 1+", "EDIT 0", "EDIT 1", "EDIT 2+",
+	"EDIT 0?"
+};
+
+void editor_start(void)
+{
+	game_edit_start();
+	editor_changed();
+}
+
+void editor_stop(void)
+{
+	game_edit_stop();
+	result = EDITOR_OFF;
+	searching = 0;
+	save_error = 0;
+}
+
+/* Drops the layouts checked so far, so that the next check starts cold */
+void editor_forget(void)
+{
+	memset(checked, 0, sizeof(checked));
+	found_count = 0;
+}
+
+/* Lays out grid with the movable and rotatable tokens where from has them */
+static int transplant(const token_t from[GRID_SIZE],
+		const token_t layout[GRID_SIZE], token_t grid[GRID_SIZE])
+{
+	int8_t cell_of[TOKEN_COUNT];
+	memset(cell_of, -1, sizeof(cell_of));
+	for (int cell = 0; cell < GRID_SIZE; ++cell)
+		if (from[cell].type != TOKEN_NONE)
+			cell_of[from[cell].slot] = cell;
+	memcpy(grid, layout, GRID_SIZE * sizeof(token_t));
+	for (int cell = 0; cell < GRID_SIZE; ++cell)
+		if (layout[cell].type != TOKEN_NONE && layout[cell].can_move)
+			grid[cell].type = TOKEN_NONE;
+	for (int cell = 0; cell < GRID_SIZE; ++cell) {
+		const token_t *token = &layout[cell];
+		if (token->type == TOKEN_NONE ||
+				!(token->can_move || token->can_rotate))
+			continue;
+		int to = cell_of[token->slot];
+		if (to < 0)
+			return 0;
+		if (!token->can_move) {
+			if (to == cell)
+				grid[cell].dir = from[to].dir;
+			continue;
+		}
+		if (grid[to].type != TOKEN_NONE)
+			return 0;
+		grid[to] = *token;
+		if (token->can_rotate)
+			grid[to].dir = from[to].dir;
+	}
+	return 1;
+}
+
+/* Whether two layouts have the same tokens the same way round */
+static int same_layout(const token_t *a, const token_t *b)
+{
+	for (int cell = 0; cell < GRID_SIZE; ++cell)
+		if (a[cell].type != b[cell].type || (a[cell].type !=
+				TOKEN_NONE && a[cell].dir != b[cell].dir))
+			return 0;
+	return 1;
+}
+
+/* Keeps the solutions found before that still solve layout, one trace each */
+static int reuse_found(const token_t layout[GRID_SIZE], int targets)
+{
+	int req = 0;
+	for (int cell = 0; cell < GRID_SIZE; ++cell)
+		req += layout[cell].type == TOKEN_TARGET &&
+			layout[cell].req_target;
+	int count = 0;
+	for (int i = 0; i < found_count; ++i) {
+		token_t grid[GRID_SIZE];
+		path_t beam[BEAM_MAX];
+		trace_t trace;
+		if (!transplant(found[i], layout, grid) || !game_trace(grid,
+				targets - req, beam, &trace) ||
+				!game_trace_solves(&trace, targets) ||
+				(count && same_layout(grid, found[0])))
+			continue;
+		memcpy(found[count++], grid, sizeof(grid));
+	}
+	found_count = count;
+	return count;
+}
+
+/* Remembers the result of the layout in key */
+static void remember(void)
+{
+	memcpy(checked[checked_next].key, key, KEY_BYTES);
+	checked[checked_next].result = result;
+	checked_next = (checked_next + 1) % EDITOR_CHECKED;
+}
+
+/* Starts checking the puzzle over, unless it was checked lately */
+void editor_changed(void)
+{
+	token_t grid[GRID_SIZE];
+	for (int i = 0; i < GRID_SIZE; ++i) {
+		token_t *token = game_get_token(i / GRID_WIDTH, i % GRID_WIDTH);
+		grid[i] = *token;
+		key[i] = token->type == TOKEN_NONE ? 0 : (token->can_move << 7) |
+			(token->can_rotate << 6) | (token->req_target << 5) |
+			(token->dir << 3) | token->type;
+	}
+	key[GRID_SIZE] = get_targets_req();
+	save_error = 0;
+	searching = 0;
+	for (int i = 0; i < EDITOR_CHECKED; ++i)
+		if (checked[i].result && !memcmp(checked[i].key, key, KEY_BYTES)) {
+			result = checked[i].result;
+			return;
+		}
+	int reused = reuse_found(grid, get_targets_req());
+	if (reused == 2) {
+		result = EDITOR_MANY;
+		remember();
+		return;
+	}
+	solver_start(grid, get_targets_req());
+	solutions = 0;
+	searching = 1;
+	result = reused ? EDITOR_SOME : EDITOR_BUSY;
+}
+
+/* Idle task: counts solutions up to two, within EDITOR_TRACES traces */
+int editor_check(void)
+{
+	if (!searching)
+		return 0;
+	solver_status_t status = solver_step(EDITOR_STEPS);
+	if (status == SOLVER_BUSY && solver_traces() < EDITOR_TRACES)
+		return 1;
+	if (status == SOLVER_SOLVED) {
+		solver_solution(found[solutions]);
+		found_count = ++solutions;
+		if (solutions < 2) {
+			if (result == EDITOR_BUSY)
+				finished = 1;
+			result = EDITOR_SOME;
+			solver_resume();
+			return 1;
+		}
+	}
+	if (status != SOLVER_BUSY)
+		result = solutions == 0 ? EDITOR_NONE : solutions == 1 ?
+			EDITOR_ONE : EDITOR_MANY;
+	else if (result == EDITOR_BUSY)
+		result = EDITOR_GAVE_UP;
+	searching = 0;
+	remember();
+	finished = 1;
+	return 0;
+}
+
+/* Timer: ends the wait for a key once the result has changed */
+int editor_poll(void)
+{
+	int wake = finished;
+	finished = 0;
+	return wake;
+}
+
+editor_result_t editor_result(void)
+{
+	return result;
+}
+
+/* Notes whether the last save went through, for the header */
+void editor_saved(int ok)
+{
+	save_error = !ok;
+}
+
+int editor_save_error(void)
+{
+	return save_error;
+}
+
+/* What the header shows, or NULL outside of the editor */
+const char *editor_label(void)
+{
+	return save_error ? "NO SAVE" : labels[result];
+}
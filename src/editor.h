@@ -0,0 +1,49 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "game.h"
+
+#define EDITOR_STEPS 32
+#define EDITOR_POLL_TICKS 2
+#define EDITOR_CHECKED 8
+#define EDITOR_TRACES 20000
+
+typedef enum {
+	EDITOR_OFF,
+	EDITOR_BUSY,
+	EDITOR_SOME,
+	EDITOR_NONE,
+	EDITOR_ONE,
+	EDITOR_MANY,
+	EDITOR_GAVE_UP
+} editor_result_t;
+
+void editor_start(void);
+void editor_stop(void);
+void editor_forget(void);
+void editor_changed(void);
+int editor_check(void);
+int editor_poll(void);
+editor_result_t editor_result(void);
+void editor_saved(int ok);
+int editor_save_error(void);
+const char *editor_label(void);
@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022, 2025  Jeffry Johnston
+Copyright (C) 2022, 2025, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -18,11 +18,30 @@ You should have received a copy of the GNU General Public License
 along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <stddef.h>
 #include <gint/bfile.h>
 #include <gint/gint.h>
+#include "file.h"
 #include "game.h"
+#include "pack.h"
+#include "trace.h"
 
 #define FLASH u"\\\\fls0\\"
+#define PATH_MAX (8 + PACK_NAME_MAX + 1)
+#define FOUND_MAX 64
+
+static void make_path(uint16_t *path, const char *name, const char *ext)
+{
+	const uint16_t *flash = FLASH;
+	while (*flash)
+		*path++ = *flash++;
+	while (*name && !(ext && *name == '.'))
+		*path++ = *name++;
+	if (ext)
+		while (*ext)
+			*path++ = *ext++;
+	*path = 0;
+}
 
 static int read_file(const uint16_t *path, char *buf, const int size)
 {
@@ -51,38 +70,263 @@ static int write_file(const uint16_t *path, const char *buf, int size)
 	return 0;
 }
 
-int file_read_puzzles(char *buf)
+/*
+A raw pack: the puzzle records, then the title padded with a space to an even
+size. A title too long to pad is cut to PACK_TITLE_MAX rounded down to even.
+*/
+static int write_pack(const uint16_t *path, const char *buf, int size,
+	const char *title)
+{
+	char padded[PACK_TITLE_MAX + 1];
+	int title_size = 0;
+	while (title[title_size] && title_size < (PACK_TITLE_MAX & ~1)) {
+		padded[title_size] = title[title_size];
+		++title_size;
+	}
+	if (title_size & 1)
+		padded[title_size++] = ' ';
+	int total = size + title_size;
+	BFile_Remove(path);
+	if (BFile_Create(path, BFile_File, &total) < 0)
+		return 20;
+	int fd = BFile_Open(path, BFile_WriteOnly);
+	if (fd < 0)
+		return 21;
+	if (BFile_Write(fd, buf, size) < 0 || (title_size &&
+			BFile_Write(fd, padded, title_size) < 0)) {
+		BFile_Close(fd);
+		return 22;
+	}
+	if (BFile_Close(fd) < 0)
+		return 23;
+	return 0;
+}
+
+static int scan_packs(pack_t *packs, const int max)
+{
+	uint16_t found[FOUND_MAX];
+	struct BFile_FileInfo info;
+	int handle;
+	if (BFile_FindFirst(FLASH PACK_PATTERN, &handle, found, &info) < 0)
+		return 0;
+
+	int count = 0;
+	do {
+		int len = 0;
+		while (found[len] && len <= PACK_NAME_MAX)
+			++len;
+		if (len > PACK_NAME_MAX)
+			continue;
+		pack_t *pack = &packs[count++];
+		for (int i = 0; i <= len; ++i)
+			pack->name[i] = found[i];
+		pack->stamp = info.file_size;
+	} while (count < max && BFile_FindNext(handle, found, &info) >= 0);
+	BFile_FindClose(handle);
+	return count;
+}
+
+static int read_pack_info(const uint16_t *path, pack_t *pack)
+{
+	const int fd = BFile_Open(path, BFile_ReadOnly);
+	if (fd < 0)
+		return 10;
+	const int size = BFile_Size(fd);
+	if (size < 0) {
+		BFile_Close(fd);
+		return 13;
+	}
+	char head[PACK_HEAD_MAX];
+	if (BFile_Read(fd, head, size < PACK_HEAD_MAX ? size : PACK_HEAD_MAX,
+			0) < 0) {
+		BFile_Close(fd);
+		return 11;
+	}
+
+	pack_info_t info;
+	pack_info(head, size, &info);
+	if (info.title_size > PACK_TITLE_MAX)
+		info.title_size = PACK_TITLE_MAX;
+	for (int i = 0; i <= PACK_TITLE_MAX; ++i)
+		pack->title[i] = 0;
+	if (info.title_size && BFile_Read(fd, pack->title, info.title_size,
+			info.title_offset) < 0) {
+		BFile_Close(fd);
+		return 11;
+	}
+	if (BFile_Close(fd) < 0)
+		return 12;
+
+	// Drop the padding of raw packs, and the NUL older saves padded with
+	int end = info.title_size;
+	while (end > 0 && (pack->title[end - 1] == ' ' ||
+			!pack->title[end - 1]))
+		pack->title[--end] = 0;
+
+	pack->puzzles = info.count;
+	pack->bytes = info.bytes;
+	return 0;
+}
+
+/* Runs a BFile call in the OS world, traced as file I/O */
+static int world_switch(gint_call_t call)
+{
+	TRACE_ADD(TRACE_FILE, TRACE_BEGIN);
+	int rc = gint_world_switch(call);
+	TRACE_ADD(TRACE_FILE, TRACE_END);
+	return rc;
+}
+
+/* BFile_Write() requires an even size */
+static int solved_bytes(const pack_t *pack)
 {
-	return gint_world_switch((gint_call_t) {
+	return (pack->puzzles + 1) & ~1;
+}
+
+int file_scan_packs(pack_t *packs, int max)
+{
+	return world_switch((gint_call_t) {
+		.function = (void *)scan_packs,
+		.args = {
+			GINT_CALL_ARG((void *)packs),
+			GINT_CALL_ARG(max)
+		}
+	});
+}
+
+int file_read_pack_info(pack_t *pack)
+{
+	uint16_t path[PATH_MAX];
+	make_path(path, pack->name, NULL);
+	return world_switch((gint_call_t) {
+		.function = (void *)read_pack_info,
+		.args = {
+			GINT_CALL_ARG(path),
+			GINT_CALL_ARG((void *)pack)
+		}
+	});
+}
+
+int file_read_pack(const pack_t *pack, char *buf)
+{
+	uint16_t path[PATH_MAX];
+	make_path(path, pack->name, NULL);
+	return world_switch((gint_call_t) {
 		.function = (void *)read_file,
 		.args = {
-			GINT_CALL_ARG(FLASH PUZZLE_FILENAME),
+			GINT_CALL_ARG(path),
 			GINT_CALL_ARG(buf),
-			GINT_CALL_ARG(PUZZLE_BYTES)
+			GINT_CALL_ARG((int)pack->bytes)
+		}
+	});
+}
+
+int file_write_pack(const pack_t *pack, const char *buf, int size,
+	const char *title)
+{
+	uint16_t path[PATH_MAX];
+	make_path(path, pack->name, NULL);
+	return world_switch((gint_call_t) {
+		.function = (void *)write_pack,
+		.args = {
+			GINT_CALL_ARG(path),
+			GINT_CALL_ARG(buf),
+			GINT_CALL_ARG(size),
+			GINT_CALL_ARG(title)
+		}
+	});
+}
+
+int file_read_solved(const pack_t *pack, char *buf)
+{
+	uint16_t path[PATH_MAX];
+	make_path(path, pack->name, SOLVED_EXT);
+	return world_switch((gint_call_t) {
+		.function = (void *)read_file,
+		.args = {
+			GINT_CALL_ARG(path),
+			GINT_CALL_ARG(buf),
+			GINT_CALL_ARG(solved_bytes(pack))
+		}
+	});
+}
+
+int file_write_solved(const pack_t *pack, char *buf)
+{
+	uint16_t path[PATH_MAX];
+	make_path(path, pack->name, SOLVED_EXT);
+	return world_switch((gint_call_t) {
+		.function = (void *)write_file,
+		.args = {
+			GINT_CALL_ARG(path),
+			GINT_CALL_ARG(buf),
+			GINT_CALL_ARG(solved_bytes(pack))
+		}
+	});
+}
+
+int file_read_snapshots(const pack_t *pack, uint8_t *buf)
+{
+	uint16_t path[PATH_MAX];
+	make_path(path, pack->name, SNAPSHOT_EXT);
+	return world_switch((gint_call_t) {
+		.function = (void *)read_file,
+		.args = {
+			GINT_CALL_ARG(path),
+			GINT_CALL_ARG(buf),
+			GINT_CALL_ARG(SNAPSHOT_BYTES)
+		}
+	});
+}
+
+int file_write_snapshots(const pack_t *pack, uint8_t *buf)
+{
+	uint16_t path[PATH_MAX];
+	make_path(path, pack->name, SNAPSHOT_EXT);
+	return world_switch((gint_call_t) {
+		.function = (void *)write_file,
+		.args = {
+			GINT_CALL_ARG(path),
+			GINT_CALL_ARG(buf),
+			GINT_CALL_ARG(SNAPSHOT_BYTES)
+		}
+	});
+}
+
+int file_write_record(const pack_t *pack, const uint8_t *buf, int size)
+{
+	uint16_t path[PATH_MAX];
+	make_path(path, pack->name, RECORD_EXT);
+	return world_switch((gint_call_t) {
+		.function = (void *)write_file,
+		.args = {
+			GINT_CALL_ARG(path),
+			GINT_CALL_ARG((void *)buf),
+			GINT_CALL_ARG(size)
 		}
 	});
 }
 
-int file_read_solved(char *buf)
+int file_read_dir(void *buf, int size)
 {
-	return gint_world_switch((gint_call_t) {
+	return world_switch((gint_call_t) {
 		.function = (void *)read_file,
 		.args = {
-			GINT_CALL_ARG(FLASH SOLVED_FILENAME),
+			GINT_CALL_ARG(FLASH DIR_FILENAME),
 			GINT_CALL_ARG(buf),
-			GINT_CALL_ARG(PUZZLE_COUNT)
+			GINT_CALL_ARG(size)
 		}
 	});
 }
 
-int file_write_solved(char *buf)
+int file_write_dir(void *buf, int size)
 {
-	return gint_world_switch((gint_call_t) {
+	return world_switch((gint_call_t) {
 		.function = (void *)write_file,
 		.args = {
-			GINT_CALL_ARG(FLASH SOLVED_FILENAME),
+			GINT_CALL_ARG(FLASH DIR_FILENAME),
 			GINT_CALL_ARG(buf),
-			GINT_CALL_ARG(PUZZLE_COUNT)
+			GINT_CALL_ARG(size)
 		}
 	});
 }
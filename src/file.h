@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022  Jeffry Johnston
+Copyright (C) 2022, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -20,6 +20,17 @@ along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
-int file_read_puzzles(char *buf);
-int file_read_solved(char *buf);
-int file_write_solved(char *buf);
+#include "library.h"
+
+int file_scan_packs(pack_t *packs, int max);
+int file_read_pack_info(pack_t *pack);
+int file_read_pack(const pack_t *pack, char *buf);
+int file_write_pack(const pack_t *pack, const char *buf, int size,
+	const char *title);
+int file_read_solved(const pack_t *pack, char *buf);
+int file_write_solved(const pack_t *pack, char *buf);
+int file_read_snapshots(const pack_t *pack, uint8_t *buf);
+int file_write_snapshots(const pack_t *pack, uint8_t *buf);
+int file_write_record(const pack_t *pack, const uint8_t *buf, int size);
+int file_read_dir(void *buf, int size);
+int file_write_dir(void *buf, int size);
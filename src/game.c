@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022  Jeffry Johnston
+Copyright (C) 2022, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -18,10 +18,19 @@ You should have received a copy of the GNU General Public License
 along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <string.h>
 #include "file.h"
 #include "game.h"
+#include "pack.h"
 
 #define NO_SELECTION -1
+#define SNAPSHOT_END 0xff
+
+#define MOVE_NONE 0
+#define MOVE_RELOCATE 1
+#define MOVE_ROTATE 2
+#define NOT_TRACED 0xff
+#define TARGETS_MAX 3
 
 typedef struct {
 	uint8_t id;
@@ -31,20 +40,50 @@ typedef struct {
 	token_t grid[GRID_SIZE];
 } puzzle_t;
 
+/* A beam traced up to a path, which can be followed on from there */
+typedef struct {
+	trace_t trace;
+	uint8_t next;
+	uint8_t req_hit;
+	uint8_t extra_hit;
+	uint32_t hit;
+} tracer_t;
+
 static char puzzles[PUZZLE_BYTES];
+static int puzzle_bytes;
+static int puzzle_count;
 static int puzzle_i;
 static puzzle_t puzzle;
-static char solved[PUZZLE_COUNT];
+static int load_count;
+static int pack_count;
+static char solved[PUZZLE_MAX];
 static int is_winner;
 
+static uint8_t snapshots[SNAPSHOT_BYTES];
+static int snapshot_used;
+static int snapshot_dirty;
+
 static int cursor_row;
 static int cursor_col;
 static int selection;
+static uint32_t preview;
+static int preview_dirty;
 static int path_count;
 static path_t beam[BEAM_MAX];
+static int beam_dirty;
+
+static uint8_t history[HISTORY_BYTES];
+static int history_used;
+static int history_current;
+
+static int editing;
+static const uint8_t token_max[] = {
+	GRID_SIZE, BLOCK_COUNT, CHECKPOINT_COUNT, LASER_COUNT, MIRROR_COUNT,
+	SPLITTER_COUNT, TARGET_COUNT
+};
 
 /*
-For 60 puzzles:
+For each puzzle (up to PUZZLE_MAX):
 	1 byte
 	------
 	ID
@@ -66,30 +105,264 @@ For 60 puzzles:
 		7    | 6   | 5   | 4 3 | 2 1 0
 		MOVE | ROT | REQ | DIR | TYPE
 	SUBTOTAL: 24 bytes per puzzle
-TOTAL: 60 * 24 = 1440 bytes in the file
+Optional pack title (up to 23 bytes, see library.c)
+TOTAL: 60 * 24 = 1440 bytes in the original LASER.dat
 */
-static void load_puzzle(void)
+/*
+Snapshots keep the layout of puzzles that were left unsolved or rearranged,
+oldest first:
+	1 byte
+	------
+	PUZZLE INDEX (0xff: end of snapshots)
+
+	1 byte
+	------
+	N = number of tokens that were moved or rotated
+
+	N pieces = 2N bytes
+	-------------------
+		1 byte: current cell location
+		-----------------------------
+		7 6 5 | 4 3 2 1 0
+		RSVD  | LOC
+
+		1 byte: token
+		-------------
+		7 6 | 5 4 | 3 2 1 0
+		RSVD| DIR | SLOT (piece index in the puzzle record)
+When full, the oldest snapshots are dropped.
+*/
+static int snapshot_size(const uint8_t *entry)
 {
-	char *p = puzzles + BYTES_PER_PUZZLE * puzzle_i;
+	return 2 + 2 * entry[1];
+}
 
-	// Init fields
-	selection = NO_SELECTION;
-	path_count = 0;
-	puzzle.id = *p++;
-	puzzle.targets_req = *p++;
-	puzzle.targets_hit = 0;
-	token_t *grid = puzzle.grid;
+static uint8_t *find_snapshot(int i)
+{
+	for (int pos = 0; pos < snapshot_used;
+			pos += snapshot_size(snapshots + pos))
+		if (snapshots[pos] == i)
+			return snapshots + pos;
+	return NULL;
+}
+
+static void remove_snapshot(uint8_t *entry)
+{
+	int size = snapshot_size(entry);
+	uint8_t *end = snapshots + snapshot_used;
+	memmove(entry, entry + size, end - entry - size);
+	snapshot_used -= size;
+	memset(snapshots + snapshot_used, SNAPSHOT_END, size);
+}
+
+static void restore_snapshot(void)
+{
+	const uint8_t *entry = find_snapshot(puzzle_i);
+	if (!entry)
+		return;
+	const char *rec = pack_record(puzzle_i) + 2;
+
+	// Lift every changed token first, since they may swap places
+	token_t lifted[TOKEN_COUNT];
+	int from[TOKEN_COUNT];
+	int to[TOKEN_COUNT];
+	int count = 0;
+	for (int i = 0; i < entry[1]; ++i) {
+		int loc = entry[2 + 2 * i];
+		int data = entry[3 + 2 * i];
+		int slot = data & 0x0f;
+		if (loc >= GRID_SIZE || slot >= TOKEN_COUNT)
+			continue;
+		int cell = rec[2 * slot];
+		if (cell < 0 || cell >= GRID_SIZE)
+			continue;
+		token_t *token = &puzzle.grid[cell];
+		if (token->type == TOKEN_NONE || token->slot != slot)
+			continue;
+		lifted[count] = *token;
+		lifted[count].dir = (data >> 4) & 0x03;
+		from[count] = cell;
+		to[count++] = loc;
+		token->type = TOKEN_NONE;
+	}
+
+	// Put them down, or all back if the snapshot does not fit the record
+	uint32_t taken = 0;
 	for (int i = 0; i < GRID_SIZE; ++i)
-		puzzle.grid[i].type = TOKEN_NONE;
+		if (puzzle.grid[i].type != TOKEN_NONE)
+			taken |= 1UL << i;
+	int fits = 1;
+	for (int i = 0; i < count; ++i) {
+		if (taken & (1UL << to[i]))
+			fits = 0;
+		taken |= 1UL << to[i];
+	}
+	for (int i = 0; i < count; ++i)
+		puzzle.grid[fits ? to[i] : from[i]] = lifted[i];
+}
+
+/*
+History entries, oldest first. Each one is a move and the state it led to,
+so that undo and redo do not have to trace the beam again:
+	1 byte: MOVE kind
+	2 bytes: move
+		RELOCATE: from cell, to cell
+		ROTATE: cell, old dir << 2 | new dir
+	1 byte: N = number of paths, or NOT_TRACED
+	If traced:
+		1 byte: targets hit
+		4 bytes: tokens hit, one bit per cell
+		N pieces = 2N bytes: path
+		-------------------------
+		15 14 13 12 | 11 10 9 | 8 7 6 | 5 4 3 | 2 1 0
+		RSVD        | ROW     | COL   | ENTRY | EXIT
+	1 byte: size of the entry
+The first entry is the puzzle as loaded. When full, the oldest entries are
+dropped. history_current is the end of the entry shown on screen; entries
+after it can be redone.
+*/
+static int history_size(const uint8_t *entry)
+{
+	return entry[3] == NOT_TRACED ? 5 : 10 + 2 * entry[3];
+}
+
+static void history_drop_oldest(void)
+{
+	int size = history_size(history);
+	memmove(history, history + size, history_used - size);
+	history_used -= size;
+	history_current -= size;
+}
+
+static void history_record(int kind, int a, int b)
+{
+	history_used = history_current;
+	while (history_used + 5 > HISTORY_BYTES)
+		history_drop_oldest();
+	uint8_t *entry = history + history_used;
+	entry[0] = kind;
+	entry[1] = a;
+	entry[2] = b;
+	entry[3] = NOT_TRACED;
+	entry[4] = 5;
+	history_used += 5;
+	history_current = history_used;
+	beam_dirty = 1;
+}
+
+/* Caches the traced state in the last entry, if it is the one shown */
+static void history_fill(void)
+{
+	if (!history_used || history_current != history_used ||
+			history[history_used - 2] != NOT_TRACED)
+		return;
+	int size = 10 + 2 * path_count;
+	while (history_used + size - 5 > HISTORY_BYTES)
+		history_drop_oldest();
+	uint8_t *entry = history + history_used - 5;
+	uint32_t hit = 0;
+	for (int i = 0; i < GRID_SIZE; ++i)
+		if (puzzle.grid[i].hit)
+			hit |= 1UL << i;
+	entry[3] = path_count;
+	entry[4] = puzzle.targets_hit;
+	memcpy(entry + 5, &hit, 4);
+	uint8_t *p = entry + 9;
+	for (int i = 0; i < path_count; ++i) {
+		path_t *path = &beam[i];
+		int packed = (path->row << 9) | (path->col << 6) |
+				(path->entry << 3) | path->exit;
+		*p++ = packed >> 8;
+		*p++ = packed;
+	}
+	*p = size;
+	history_used += size - 5;
+	history_current = history_used;
+}
+
+static void history_restore(const uint8_t *entry)
+{
+	if (entry[3] == NOT_TRACED) {
+		beam_dirty = 1;
+		return;
+	}
+	uint32_t hit;
+	memcpy(&hit, entry + 5, 4);
+	for (int i = 0; i < GRID_SIZE; ++i)
+		puzzle.grid[i].hit = (hit >> i) & 0x01;
+	puzzle.targets_hit = entry[4];
+	path_count = entry[3];
+	const uint8_t *p = entry + 9;
+	for (int i = 0; i < path_count; ++i, p += 2) {
+		int packed = (p[0] << 8) | p[1];
+		path_t *path = &beam[i];
+		path->row = (packed >> 9) & 0x07;
+		path->col = (packed >> 6) & 0x07;
+		path->entry = (packed >> 3) & 0x07;
+		path->exit = packed & 0x07;
+	}
+	beam_dirty = 0;
+}
+
+static void history_move(const uint8_t *entry, int undo)
+{
+	int cell = entry[1];
+	if (entry[0] == MOVE_RELOCATE) {
+		int from = undo ? entry[2] : entry[1];
+		cell = undo ? entry[1] : entry[2];
+		puzzle.grid[cell] = puzzle.grid[from];
+		puzzle.grid[from].type = TOKEN_NONE;
+	} else if (entry[0] == MOVE_ROTATE) {
+		puzzle.grid[cell].dir = undo ? entry[2] >> 2 : entry[2] & 0x03;
+	}
+	cursor_row = cell / GRID_WIDTH;
+	cursor_col = cell % GRID_WIDTH;
+	selection = NO_SELECTION;
+}
+
+int game_undo(void)
+{
+	if (!history_current)
+		return 0;
+	int size = history[history_current - 1];
+	int start = history_current - size;
+	if (!start)
+		return 0;
+	history_move(history + start, 1);
+	int prev = start - history[start - 1];
+	history_restore(history + prev);
+	history_current = start;
+	return 1;
+}
+
+int game_redo(void)
+{
+	if (history_current >= history_used)
+		return 0;
+	const uint8_t *entry = history + history_current;
+	history_move(entry, 0);
+	history_restore(entry);
+	history_current += history_size(entry);
+	return 1;
+}
 
-	// Add tokens
+/*
+Places the tokens of a puzzle record on an empty grid. Packs are only fully
+checked when pushed over USB, so tokens off the grid are left out.
+*/
+static void decode_tokens(const char *p, token_t *grid)
+{
+	p += 2;
+	for (int i = 0; i < GRID_SIZE; ++i)
+		grid[i].type = TOKEN_NONE;
 	for (int i = 0; i < TOKEN_COUNT; ++i) {
-		int loc = *p++;
-		token_t *token = &grid[loc];
-		int data = *p++;
+		int loc = (uint8_t)*p++;
+		int data = (uint8_t)*p++;
 		int type = data & 0x07;
-		if (type != TOKEN_NONE) {
+		if (type != TOKEN_NONE && loc < GRID_SIZE) {
+			token_t *token = &grid[loc];
 			token->type = type;
+			token->slot = i;
 			data >>= 3;
 			token->dir = data & 0x03;
 			data >>= 2;
@@ -100,7 +373,32 @@ static void load_puzzle(void)
 			token->can_move = data;
 		}
 	}
+}
+
+/* Number of targets to hit besides the required ones */
+static void count_targets(void)
+{
+	int req = 0;
+	for (int i = 0; i < GRID_SIZE; ++i)
+		if (puzzle.grid[i].type == TOKEN_TARGET &&
+				puzzle.grid[i].req_target)
+			++req;
+	puzzle.targets_extra = puzzle.targets_req - req;
+}
+
+static void load_puzzle(void)
+{
+	const char *p = pack_record(puzzle_i);
 
+	// Init fields
+	++load_count;
+	selection = NO_SELECTION;
+	path_count = 0;
+	puzzle.id = p[0];
+	puzzle.targets_req = p[1];
+	puzzle.targets_hit = 0;
+	token_t *grid = puzzle.grid;
+	decode_tokens(p, grid);
 
 	// Find laser and set cursor
 	int cell = 0;
@@ -109,27 +407,28 @@ static void load_puzzle(void)
 		if (type == TOKEN_LASER)
 			cell = i;
 	}
-	cursor_row = cell / GRID_HEIGHT;
-	cursor_col = cell % GRID_HEIGHT;
+	cursor_row = cell / GRID_WIDTH;
+	cursor_col = cell % GRID_WIDTH;
 
-	// Determine number of extra targets
-	int req = 0;
-	for (int i = 0; i < GRID_SIZE; ++i)
-		if (grid[i].type == TOKEN_TARGET && grid[i].req_target)
-			++req;
-	puzzle.targets_extra = puzzle.targets_req - req;
+	count_targets();
+	restore_snapshot();
+
+	// Start a new history with the puzzle as loaded
+	history_used = 0;
+	history_current = 0;
+	history_record(MOVE_NONE, 0, 0);
 }
 
 static int find_unsolved_puzzle(void)
 {
 	int unsolved = -1;
-	for (int i = 0; i < PUZZLE_COUNT; ++i)
+	for (int i = 0; i < puzzle_count; ++i)
 		if (solved[i] != '1') {
 			unsolved = i;
 			break;
 		}
 	if (unsolved == -1) {
-		unsolved = PUZZLE_COUNT - 1;
+		unsolved = puzzle_count - 1;
 		is_winner = 1;
 	} else {
 		is_winner = 0;
@@ -137,12 +436,29 @@ static int find_unsolved_puzzle(void)
 	return unsolved;
 }
 
-int game_init(int init_solved)
+int game_init(int size, int init_solved)
 {
+	puzzle_bytes = size;
+	puzzle_count = pack_open(puzzles, size);
+	++pack_count;
+	if (!puzzle_count)
+		return 14;
 	if (init_solved)
-		for (int i = 0; i < PUZZLE_COUNT; ++i)
+		for (int i = 0; i < PUZZLE_MAX; ++i)
 			solved[i] = '0';
 
+	// Keep only well-formed snapshots
+	snapshot_used = 0;
+	snapshot_dirty = 0;
+	while (snapshot_used + 2 <= SNAPSHOT_BYTES &&
+			snapshots[snapshot_used] < puzzle_count &&
+			snapshots[snapshot_used + 1] <= TOKEN_COUNT &&
+			snapshot_used + snapshot_size(snapshots +
+				snapshot_used) <= SNAPSHOT_BYTES)
+		snapshot_used += snapshot_size(snapshots + snapshot_used);
+	memset(snapshots + snapshot_used, SNAPSHOT_END,
+		SNAPSHOT_BYTES - snapshot_used);
+
 	// Find first unsolved puzzle
 	puzzle_i = find_unsolved_puzzle();
 
@@ -152,11 +468,74 @@ int game_init(int init_solved)
 	return 0;
 }
 
+static int check_puzzle(const char *p)
+{
+	uint32_t taken = 0;
+	int lasers = 0;
+	p += 2;
+	for (int i = 0; i < TOKEN_COUNT; ++i) {
+		int loc = *p++;
+		int type = *p++ & 0x07;
+		if (type == TOKEN_NONE)
+			continue;
+		if (type > TOKEN_TARGET || loc < 0 || loc >= GRID_SIZE ||
+				(taken & (1UL << loc)))
+			return 1;
+		taken |= 1UL << loc;
+		if (type == TOKEN_LASER)
+			++lasers;
+	}
+	return lasers != 1;
+}
+
+/*
+Replaces the puzzles with a pack that only lives in RAM, staying on the same
+puzzle number. Nothing is changed unless every puzzle is well-formed.
+*/
+int game_load_pack(const char *data, int size)
+{
+	int count = pack_open(data, size);
+	int ok = count > 0;
+	for (int i = 0; ok && i < count; ++i)
+		ok = !check_puzzle(pack_record(i));
+	if (!ok) {
+		pack_open(puzzles, puzzle_bytes);
+		return 1;
+	}
+
+	if (size > PUZZLE_BYTES)
+		size = PUZZLE_BYTES;
+	memcpy(puzzles, data, size);
+	puzzle_bytes = size;
+	puzzle_count = pack_open(puzzles, size);
+	++pack_count;
+	for (int i = 0; i < PUZZLE_MAX; ++i)
+		solved[i] = '0';
+	snapshot_used = 0;
+	snapshot_dirty = 0;
+	memset(snapshots, SNAPSHOT_END, SNAPSHOT_BYTES);
+	find_unsolved_puzzle();
+	if (puzzle_i >= count)
+		puzzle_i = count - 1;
+	load_puzzle();
+	return 0;
+}
+
 int game_is_cursor(int row, int col)
 {
 	return (row == cursor_row) && (col == cursor_col);
 }
 
+int game_get_cursor_row(void)
+{
+	return cursor_row;
+}
+
+int game_get_cursor_col(void)
+{
+	return cursor_col;
+}
+
 int game_is_selection(int row, int col)
 {
 	return (GRID_WIDTH * row + col) == selection;
@@ -182,11 +561,118 @@ char *game_get_solved(void)
 	return solved;
 }
 
+uint8_t *game_get_snapshots(void)
+{
+	return snapshots;
+}
+
+int game_snapshots_dirty(void)
+{
+	return snapshot_dirty;
+}
+
+/* Bytes of the snapshot buffer in use, the rest is SNAPSHOT_END */
+int game_get_snapshot_bytes(void)
+{
+	return snapshot_used;
+}
+
+void game_snapshots_saved(void)
+{
+	snapshot_dirty = 0;
+}
+
+void game_snapshot(void)
+{
+	// The layout being edited is not the one in the record
+	if (editing)
+		return;
+
+	// Compare each token against its puzzle record
+	const char *rec = pack_record(puzzle_i) + 2;
+	uint8_t entry[2 + 2 * TOKEN_COUNT];
+	int count = 0;
+	for (int i = 0; i < GRID_SIZE; ++i) {
+		token_t *token = &puzzle.grid[i];
+		if (token->type == TOKEN_NONE)
+			continue;
+		int loc = rec[2 * token->slot];
+		int dir = (rec[2 * token->slot + 1] >> 3) & 0x03;
+		if (i == loc && token->dir == dir)
+			continue;
+		entry[2 + 2 * count] = i;
+		entry[3 + 2 * count] = (token->dir << 4) | token->slot;
+		++count;
+	}
+	entry[0] = puzzle_i;
+	entry[1] = count;
+	int size = snapshot_size(entry);
+
+	// Replace the previous snapshot, if any
+	uint8_t *old = find_snapshot(puzzle_i);
+	if (old) {
+		if (!memcmp(old, entry, size))
+			return;
+		remove_snapshot(old);
+	} else if (!count) {
+		return;
+	}
+	snapshot_dirty = 1;
+	if (!count)
+		return;
+	while (snapshot_used + size > SNAPSHOT_BYTES)
+		remove_snapshot(snapshots);
+	memcpy(snapshots + snapshot_used, entry, size);
+	snapshot_used += size;
+}
+
+int game_get_puzzle_count(void)
+{
+	return puzzle_count;
+}
+
+int game_get_solved_count(void)
+{
+	int count = 0;
+	for (int i = 0; i < puzzle_count; ++i)
+		if (solved[i] == '1')
+			++count;
+	return count;
+}
+
+int game_get_puzzle_index(void)
+{
+	return puzzle_i;
+}
+
 int game_get_puzzle_id(void)
 {
 	return puzzle.id;
 }
 
+/* Changes each time a puzzle is loaded */
+int game_get_load_count(void)
+{
+	return load_count;
+}
+
+/* Changes each time the puzzles are replaced by another pack */
+int game_get_pack_count(void)
+{
+	return pack_count;
+}
+
+/*
+Tokens of any puzzle in the pack as first laid out, without loading it.
+Returns the number of targets to hit.
+*/
+int game_get_layout(int i, token_t grid[GRID_SIZE])
+{
+	const char *p = pack_record(i);
+	decode_tokens(p, grid);
+	return p[1];
+}
+
 token_t *game_get_token(int row, int col)
 {
 	return &puzzle.grid[GRID_WIDTH * row + col];
@@ -235,11 +721,14 @@ void game_select_token(void)
 	int i = GRID_WIDTH * cursor_row + cursor_col;
 	token_t *token = &(puzzle.grid[i]);
 	if (selection == NO_SELECTION) {
-		if (token->type != TOKEN_NONE && token->can_move)
+		if (token->type != TOKEN_NONE && token->can_move) {
 			selection = i;
+			preview_dirty = 1;
+		}
 	} else if (token->type == TOKEN_NONE) {
 		*token = puzzle.grid[selection];
 		puzzle.grid[selection].type = TOKEN_NONE;
+		history_record(MOVE_RELOCATE, selection, i);
 		selection = NO_SELECTION;
 	} else {
 		selection = NO_SELECTION;
@@ -262,24 +751,27 @@ void game_rotate_token(int dir)
 		new_dir = DIR_WEST;
 	else if (new_dir > DIR_WEST)
 		new_dir = DIR_NORTH;
+	history_record(MOVE_ROTATE, i, (token->dir << 2) | new_dir);
 	token->dir = new_dir;
+	preview_dirty = 1;
 }
 
-static void add_path(int cell, loc_t entry, loc_t exit)
+static void add_path(path_t *beam, trace_t *trace, int cell, loc_t entry,
+			loc_t exit)
 {
-	if (path_count >= BEAM_MAX)
+	if (trace->path_count >= BEAM_MAX)
 		return;
 
-	int row = cell / GRID_HEIGHT;
-	int col = cell % GRID_HEIGHT;
-	for (int i = 0; i < path_count; ++i) {
+	int row = cell / GRID_WIDTH;
+	int col = cell % GRID_WIDTH;
+	for (int i = 0; i < trace->path_count; ++i) {
 		path_t *path_i = &beam[i];
 		if (row == path_i->row && col == path_i->col &&
 				entry == path_i->entry && exit == path_i->exit)
 			return;
 	}
 
-	path_t *path = &beam[path_count++];
+	path_t *path = &beam[trace->path_count++];
 	path->row = row;
 	path->col = col;
 	path->entry = entry;
@@ -333,14 +825,18 @@ static loc_t loc_reflect(dir_t dir, loc_t loc)
 	return LOC_STOP;
 }
 
-int game_laser(void)
+/*
+Finds the laser of a grid and starts its beam, clearing the tokens hit.
+Returns 0 if there is no laser.
+*/
+static int trace_start(token_t *grid, path_t *beam, tracer_t *t)
 {
 	// Find laser and count tokens (except block)
 	int cell = -1;
 	int tokens_req = 0;
 	for (int i = 0; i < GRID_SIZE; ++i) {
-		puzzle.grid[i].hit = 0;
-		token_type_t type = puzzle.grid[i].type;
+		grid[i].hit = 0;
+		token_type_t type = grid[i].type;
 		if (type == TOKEN_LASER)
 			cell = i;
 		if (type != TOKEN_NONE && type != TOKEN_BLOCK &&
@@ -350,15 +846,30 @@ int game_laser(void)
 	if (cell == -1)
 		return 0;
 
-	// Trace beam
-	int tokens_hit = 0;
-	int req_hit = 0;
-	int extra_hit = 0;
-	path_count = 0;
-	add_path(cell, LOC_STOP, (int)(puzzle.grid[cell].dir));
-	for (cell = 0; cell < path_count; ++cell) {
+	memset(t, 0, sizeof(*t));
+	t->trace.tokens_req = tokens_req;
+	add_path(beam, &t->trace, cell, LOC_STOP, (int)(grid[cell].dir));
+	return 1;
+}
+
+/*
+Follows the beam from path t->next to its end. With forks, the state before
+the beam first enters each empty cell is kept there, and the cells are
+returned as a mask.
+*/
+static uint32_t trace_follow(token_t *grid, int targets_extra, path_t *beam,
+		tracer_t *t, tracer_t *forks)
+{
+	trace_t *trace = &t->trace;
+	int tokens_hit = trace->tokens_hit;
+	int req_hit = t->req_hit;
+	int extra_hit = t->extra_hit;
+	uint32_t hit = t->hit;
+	uint32_t forked = 0;
+	int next;
+	for (next = t->next; next < trace->path_count; ++next) {
 		// Move to next cell
-		path_t *path = &beam[cell];
+		path_t *path = &beam[next];
 		loc_t entry = loc_across(path->exit);
 		int row = path->row;
 		int col = path->col;
@@ -389,12 +900,24 @@ int game_laser(void)
 		int cell = GRID_WIDTH * row + col;
 
 		// Process cell
-		token_t *token = &puzzle.grid[cell];
+		token_t *token = &grid[cell];
+		if (forks && token->type == TOKEN_NONE &&
+				!(forked & (1UL << cell))) {
+			forked |= 1UL << cell;
+			tracer_t *fork = &forks[cell];
+			fork->trace = *trace;
+			fork->trace.tokens_hit = tokens_hit;
+			fork->next = next;
+			fork->req_hit = req_hit;
+			fork->extra_hit = extra_hit;
+			fork->hit = hit;
+		}
 		if (!token->hit && token->type != TOKEN_NONE &&
 				token->type != TOKEN_BLOCK &&
 				token->type != TOKEN_LASER) {
 			++tokens_hit;
 			token->hit = 1;
+			hit |= 1UL << cell;
 		}
 		loc_t exit = LOC_STOP;
 		switch (token->type) {
@@ -426,7 +949,7 @@ int game_laser(void)
 			exit = loc_reflect(token->dir, entry);
 			break;
 		case TOKEN_SPLITTER:
-			add_path(cell, entry, loc_across(entry));
+			add_path(beam, trace, cell, entry, loc_across(entry));
 			exit = loc_reflect(token->dir, entry);
 			break;
 		case TOKEN_TARGET:
@@ -437,7 +960,7 @@ int game_laser(void)
 			if (entry == dir) {
 				if (token->req_target)
 					++req_hit;
-				else if (extra_hit < puzzle.targets_extra)
+				else if (extra_hit < targets_extra)
 					++extra_hit;
 				exit = LOC_STOP;
 			} else if (entry == dir2) {
@@ -447,13 +970,134 @@ int game_laser(void)
 			}
 			break;
 		}
-		add_path(cell, entry, exit);
+		add_path(beam, trace, cell, entry, exit);
 	}
+	t->next = next;
+	t->req_hit = req_hit;
+	t->extra_hit = extra_hit;
+	t->hit = hit;
+	trace->targets_hit = req_hit + extra_hit;
+	trace->tokens_hit = tokens_hit;
+	return forked;
+}
+
+/*
+Traces the beam of the laser over any grid, marking the tokens it hits.
+Up to targets_extra targets that are not required count as hit. Returns 0
+if there is no laser.
+*/
+int game_trace(token_t *grid, int targets_extra, path_t *beam,
+		trace_t *trace)
+{
+	tracer_t t;
+	if (!trace_start(grid, beam, &t))
+		return 0;
+	trace_follow(grid, targets_extra, beam, &t, NULL);
+	*trace = t.trace;
+	return 1;
+}
+
+/* Whether a trace solves a puzzle that needs targets_req targets */
+int game_trace_solves(const trace_t *trace, int targets_req)
+{
+	return trace->targets_hit >= targets_req &&
+		trace->tokens_hit >= trace->tokens_req;
+}
+
+/* Whether a drop outcome hits more targets or tokens than now */
+static int is_better(const trace_t *trace, const trace_t *now)
+{
+	return trace->targets_hit > now->targets_hit ||
+		trace->tokens_hit > now->tokens_hit;
+}
+
+/*
+Finds the empty cells where dropping the selected token would hit more
+targets or tokens, all in one pass. The beam without the token is traced
+once, keeping its state where it first enters each empty cell: a drop there
+only follows the beam on from that state, and a drop on a cell the beam never
+enters changes nothing. A selected laser shares no beam, so each cell is
+traced in full.
+*/
+static void preview_moves(void)
+{
+	token_t grid[GRID_SIZE];
+	path_t base[BEAM_MAX];
+	path_t paths[BEAM_MAX];
+	tracer_t forks[GRID_SIZE];
+	trace_t now;
+	tracer_t t;
+
+	preview = 0;
+	preview_dirty = 0;
+	memcpy(grid, puzzle.grid, sizeof(grid));
+	if (!game_trace(grid, puzzle.targets_extra, paths, &now))
+		return;
+	token_t held = grid[selection];
+	grid[selection].type = TOKEN_NONE;
+
+	uint32_t forked = 0;
+	int laser = held.type == TOKEN_LASER;
+	if (!laser) {
+		trace_start(grid, base, &t);
+		forked = trace_follow(grid, puzzle.targets_extra, base, &t,
+			forks);
+	}
+	for (int cell = 0; cell < GRID_SIZE; ++cell) {
+		if (puzzle.grid[cell].type != TOKEN_NONE)
+			continue;
+		if (!laser && !(forked & (1UL << cell))) {
+			if (is_better(&t.trace, &now))
+				preview |= 1UL << cell;
+			continue;
+		}
+		trace_t trace = {0};
+		grid[cell] = held;
+		if (laser) {
+			game_trace(grid, puzzle.targets_extra, paths, &trace);
+		} else {
+			tracer_t fork = forks[cell];
+			memcpy(paths, base, fork.trace.path_count *
+				sizeof(path_t));
+			for (int i = 0; i < GRID_SIZE; ++i)
+				grid[i].hit = (fork.hit >> i) & 1;
+			trace_follow(grid, puzzle.targets_extra, paths, &fork,
+				NULL);
+			trace = fork.trace;
+		}
+		grid[cell].type = TOKEN_NONE;
+		if (is_better(&trace, &now))
+			preview |= 1UL << cell;
+	}
+}
+
+/* Whether dropping the selected token on a cell would hit more */
+int game_is_preview(int row, int col)
+{
+	if (selection == NO_SELECTION)
+		return 0;
+	if (preview_dirty)
+		preview_moves();
+	return (preview >> (GRID_WIDTH * row + col)) & 1;
+}
+
+int game_laser(void)
+{
+	// Nothing moved since the last trace, or the state came from history
+	if (!beam_dirty)
+		return 0;
+	beam_dirty = 0;
+
+	trace_t trace;
+	if (!game_trace(puzzle.grid, puzzle.targets_extra, beam, &trace))
+		return 0;
+	path_count = trace.path_count;
 
 	// Determine whether puzzle has been solved
-	puzzle.targets_hit = req_hit + extra_hit;
-	if (!game_is_solved() && puzzle.targets_hit >= puzzle.targets_req &&
-			tokens_hit >= tokens_req) {
+	puzzle.targets_hit = trace.targets_hit;
+	history_fill();
+	if (!editing && !game_is_solved() &&
+			game_trace_solves(&trace, puzzle.targets_req)) {
 		solved[puzzle_i] = '1';
 		find_unsolved_puzzle();
 		return 1;
@@ -462,18 +1106,248 @@ int game_laser(void)
 	return 0;
 }
 
+/* Makes the next game_laser() trace the beam even if nothing moved */
+void game_retrace(void)
+{
+	beam_dirty = 1;
+}
+
 void game_next_puzzle(void)
 {
+	game_snapshot();
 	++puzzle_i;
-	if (puzzle_i >= PUZZLE_COUNT)
+	if (puzzle_i >= puzzle_count)
 		puzzle_i = 0;
 	load_puzzle();
 }
 
+void game_goto_puzzle(int i)
+{
+	if (i == puzzle_i || i < 0 || i >= puzzle_count)
+		return;
+	game_snapshot();
+	puzzle_i = i;
+	load_puzzle();
+}
+
+/* Starts the current puzzle over from its snapshot, with a new history */
+void game_reload_puzzle(void)
+{
+	game_snapshot();
+	load_puzzle();
+}
+
 void game_previous_puzzle(void)
 {
+	game_snapshot();
 	--puzzle_i;
 	if (puzzle_i < 0)
-		puzzle_i = PUZZLE_COUNT - 1;
+		puzzle_i = puzzle_count - 1;
 	load_puzzle();
 }
+
+/*
+The editor changes the current puzzle in place, starting from its record. The
+result only reaches the pack through game_edit_save(), and leaving the editor
+loads the puzzle again.
+*/
+int game_is_editing(void)
+{
+	return editing;
+}
+
+/* After each change: the whole board is drawn and traced again */
+static void edited(void)
+{
+	++load_count;
+	selection = NO_SELECTION;
+	puzzle.targets_hit = 0;
+	path_count = 0;
+	beam_dirty = 1;
+	count_targets();
+}
+
+void game_edit_start(void)
+{
+	game_snapshot();
+	editing = 1;
+	const char *p = pack_record(puzzle_i);
+	puzzle.targets_req = p[1];
+	decode_tokens(p, puzzle.grid);
+	history_used = 0;
+	history_current = 0;
+	edited();
+}
+
+void game_edit_stop(void)
+{
+	editing = 0;
+	load_puzzle();
+}
+
+static token_t *cursor_token(void)
+{
+	return &puzzle.grid[GRID_WIDTH * cursor_row + cursor_col];
+}
+
+/* Tokens of a type, besides the one at the cursor */
+static int count_type(int type)
+{
+	token_t *cursor = cursor_token();
+	int count = 0;
+	for (int i = 0; i < GRID_SIZE; ++i)
+		if (puzzle.grid[i].type == type && &puzzle.grid[i] != cursor)
+			++count;
+	return count;
+}
+
+/* The first piece of the record that no other token uses */
+static int free_slot(void)
+{
+	token_t *cursor = cursor_token();
+	uint32_t used = 0;
+	for (int i = 0; i < GRID_SIZE; ++i)
+		if (puzzle.grid[i].type != TOKEN_NONE &&
+				&puzzle.grid[i] != cursor)
+			used |= 1UL << puzzle.grid[i].slot;
+	int slot = 0;
+	while (used & (1UL << slot))
+		++slot;
+	return slot;
+}
+
+/* Changes the token at the cursor to the next type there is room for */
+void game_edit_type(void)
+{
+	token_t *token = cursor_token();
+	int type = token->type;
+	do {
+		type = (type + 1) % (TOKEN_TARGET + 1);
+	} while (type != TOKEN_NONE && count_type(type) >= token_max[type]);
+	if (token->type == TOKEN_NONE) {
+		memset(token, 0, sizeof(*token));
+		token->slot = free_slot();
+	}
+	token->type = type;
+	if (type != TOKEN_TARGET)
+		token->req_target = 0;
+	edited();
+}
+
+void game_edit_rotate(int dir)
+{
+	token_t *token = cursor_token();
+	if (token->type == TOKEN_NONE)
+		return;
+	token->dir = (token->dir + dir) & 0x03;
+	edited();
+}
+
+void game_edit_movable(void)
+{
+	token_t *token = cursor_token();
+	if (token->type == TOKEN_NONE)
+		return;
+	token->can_move = !token->can_move;
+	edited();
+}
+
+void game_edit_rotatable(void)
+{
+	token_t *token = cursor_token();
+	if (token->type == TOKEN_NONE)
+		return;
+	token->can_rotate = !token->can_rotate;
+	edited();
+}
+
+void game_edit_required(void)
+{
+	token_t *token = cursor_token();
+	if (token->type != TOKEN_TARGET)
+		return;
+	token->req_target = !token->req_target;
+	edited();
+}
+
+void game_edit_targets(int dir)
+{
+	int targets = puzzle.targets_req + dir;
+	if (targets < 0 || targets > TARGETS_MAX)
+		return;
+	puzzle.targets_req = targets;
+	edited();
+}
+
+/* The puzzle being edited as a record, see load_puzzle() */
+static void encode_puzzle(uint8_t *rec)
+{
+	memset(rec, 0, BYTES_PER_PUZZLE);
+	rec[0] = puzzle.id;
+	rec[1] = puzzle.targets_req;
+	for (int i = 0; i < GRID_SIZE; ++i) {
+		token_t *token = &puzzle.grid[i];
+		if (token->type == TOKEN_NONE)
+			continue;
+		uint8_t *piece = rec + 2 + 2 * token->slot;
+		piece[0] = i;
+		piece[1] = (token->can_move << 7) | (token->can_rotate << 6) |
+			(token->req_target << 5) | (token->dir << 3) |
+			token->type;
+	}
+}
+
+/* Records can only be changed in a raw pack */
+static void unpack_puzzles(void)
+{
+	if (!pack_is_compressed())
+		return;
+	char raw[PUZZLE_BYTES];
+	for (int i = 0; i < puzzle_count; ++i)
+		memcpy(raw + BYTES_PER_PUZZLE * i, pack_record(i),
+			BYTES_PER_PUZZLE);
+	puzzle_bytes = BYTES_PER_PUZZLE * puzzle_count;
+	memcpy(puzzles, raw, puzzle_bytes);
+	pack_open(puzzles, puzzle_bytes);
+}
+
+/*
+Writes the edited puzzle over its record, or with append, adds it to the end
+of the pack under a new ID and goes on editing the copy. The puzzle is then
+unsolved and its snapshot dropped. Returns 1 if the puzzle is not well-formed
+or the pack is full.
+*/
+int game_edit_save(int append)
+{
+	uint8_t rec[BYTES_PER_PUZZLE];
+	encode_puzzle(rec);
+	if (check_puzzle((const char *)rec) ||
+			(append && puzzle_count >= PUZZLE_MAX))
+		return 1;
+	unpack_puzzles();
+
+	int i = puzzle_i;
+	if (append) {
+		int id = 0;
+		for (int j = 0; j < puzzle_count; ++j)
+			if ((uint8_t)pack_record(j)[0] > id)
+				id = (uint8_t)pack_record(j)[0];
+		rec[0] = id + 1;
+		i = puzzle_count++;
+		puzzle_bytes += BYTES_PER_PUZZLE;
+	}
+	memcpy(puzzles + BYTES_PER_PUZZLE * i, rec, BYTES_PER_PUZZLE);
+	pack_open(puzzles, puzzle_bytes);
+	++pack_count;
+	puzzle_i = i;
+	puzzle.id = rec[0];
+
+	uint8_t *old = find_snapshot(i);
+	if (old) {
+		remove_snapshot(old);
+		snapshot_dirty = 1;
+	}
+	solved[i] = '0';
+	find_unsolved_puzzle();
+	return 0;
+}
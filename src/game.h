@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022  Jeffry Johnston
+Copyright (C) 2022, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -38,10 +38,11 @@ along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
 #define BEAM_MAX 2 * GRID_SIZE * SPLITTER_COUNT
 
 #define BYTES_PER_PUZZLE (2 + 2 * TOKEN_COUNT)
-#define PUZZLE_COUNT 60 /* Must be even */
-#define PUZZLE_BYTES (PUZZLE_COUNT * BYTES_PER_PUZZLE)
+#define PUZZLE_MAX 120 /* Must be even */
+#define PUZZLE_BYTES (PUZZLE_MAX * BYTES_PER_PUZZLE)
 #define PUZZLE_FILENAME "LASER.dat"
-#define SOLVED_FILENAME "LASER.cfg"
+#define SNAPSHOT_BYTES 1024
+#define HISTORY_BYTES 1024
 
 typedef enum __attribute__((__packed__)) {
 	DIR_NORTH,
@@ -75,6 +76,7 @@ typedef struct {
 	uint8_t can_rotate;
 	uint8_t req_target;
 	uint8_t hit;
+	uint8_t slot;
 } token_t;
 
 typedef struct {
@@ -84,14 +86,37 @@ typedef struct {
 	loc_t exit;
 } path_t;
 
-int game_init(int init_solved);
+/* Outcome of tracing a beam */
+typedef struct {
+	uint8_t path_count;
+	uint8_t targets_hit;
+	uint8_t tokens_hit;
+	uint8_t tokens_req;
+} trace_t;
+
+int game_init(int size, int init_solved);
+int game_load_pack(const char *data, int size);
 int game_is_cursor(int row, int col);
+int game_get_cursor_row(void);
+int game_get_cursor_col(void);
 int game_is_selection(int row, int col);
+int game_is_preview(int row, int col);
 int game_is_solved(void);
 int game_is_total_winner(void);
 char *game_get_puzzles(void);
 char *game_get_solved(void);
+uint8_t *game_get_snapshots(void);
+int game_snapshots_dirty(void);
+int game_get_snapshot_bytes(void);
+void game_snapshots_saved(void);
+void game_snapshot(void);
+int game_get_puzzle_count(void);
+int game_get_solved_count(void);
+int game_get_puzzle_index(void);
 int game_get_puzzle_id(void);
+int game_get_load_count(void);
+int game_get_pack_count(void);
+int game_get_layout(int i, token_t grid[GRID_SIZE]);
 token_t *game_get_token(int row, int col);
 int game_get_path_count(void);
 path_t *game_get_path(int i);
@@ -102,6 +127,24 @@ void game_cursor_col(int dir);
 void game_select_token(void);
 void game_deselect_token(void);
 void game_rotate_token(int dir);
+int game_undo(void);
+int game_redo(void);
+int game_trace(token_t *grid, int targets_extra, path_t *beam,
+		trace_t *trace);
+int game_trace_solves(const trace_t *trace, int targets_req);
 int game_laser(void);
+void game_retrace(void);
 void game_next_puzzle(void);
+void game_goto_puzzle(int i);
+void game_reload_puzzle(void);
 void game_previous_puzzle(void);
+int game_is_editing(void);
+void game_edit_start(void);
+void game_edit_stop(void);
+void game_edit_type(void);
+void game_edit_rotate(int dir);
+void game_edit_movable(void);
+void game_edit_rotatable(void);
+void game_edit_required(void);
+void game_edit_targets(int dir);
+int game_edit_save(int append);
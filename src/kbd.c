@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022, 2025  Jeffry Johnston
+Copyright (C) 2022, 2025, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -24,16 +24,23 @@ along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
 #include <gint/keyboard.h>
 #ifndef FX9860G_G3A
 #include <gint/usb-ff-bulk.h>
+#endif
+#ifdef FX9860G
 #include <gint/drivers/t6k11.h>
 #endif
 #include "kbd.h"
 #include "display.h"
+#include "link.h"
+#include "loop.h"
+#include "timing.h"
+#include "trace.h"
 
 #define KEY_REDRAW -1
 #define KEY_NONE -2
+#define KEY_RELOAD -3
 
 extern uint8_t debug_display;
-#ifdef FX9860G_G3A
+#ifdef FXCG50
 extern uint8_t debug_r;
 extern uint8_t debug_g;
 extern uint8_t debug_b;
@@ -50,6 +57,21 @@ void kbd_init(void)
 	usb_interface_t const *interfaces[] = { &usb_ff_bulk, NULL };
 	usb_open(interfaces, GINT_CALL_NULL);
 	ignore_keypress = false;
+
+	// Check regularly for puzzle packs sent over USB
+	loop_timer(link_poll, LINK_POLL_US / LOOP_TICK_US);
+#endif
+}
+
+void kbd_osmenu(void)
+{
+#ifndef FX9860G_G3A
+	display_menu_return();
+	ignore_keypress = true;
+#endif
+	gint_osmenu();
+#ifdef FX9860G_G3A
+	dupdate();
 #endif
 }
 
@@ -63,17 +85,31 @@ How to take an in-game screenshot:
 static void take_screenshot(void)
 {
 	if (usb_is_open()) {
-		if (display_is_using_gray_engine())
+#ifdef FX9860G
+		if (display_is_using_gray_engine()) {
 			usb_fxlink_screenshot_gray(1);
-		else
-			usb_fxlink_screenshot(1);
+			return;
+		}
+#endif
+		usb_fxlink_screenshot(1);
 	}
 }
 #endif
 
-static unsigned int kbd_getkey(void)
+/* Waits for a key, or without wait, returns KEY_NONE if no key is queued */
+static unsigned int kbd_getkey_opt(bool wait)
 {
-	key_event_t event = getkey_opt(GETKEY_BACKLIGHT, NULL);
+	if (wait) {
+		timing_reset(TIMING_KEY);
+		TRACE_ADD(TRACE_WAIT, TRACE_BEGIN);
+	}
+	key_event_t event = loop_wait(wait);
+	if (wait)
+		TRACE_ADD(TRACE_WAIT, TRACE_END);
+	if (event.type == KEYEV_NONE)
+		return wait ? KEY_RELOAD : KEY_NONE;
+	if (wait)
+		timing_enter(TIMING_KEY);
 	if (ignore_keypress) {
 		ignore_keypress = false;
 		return KEY_NONE;
@@ -85,6 +121,11 @@ static unsigned int kbd_getkey(void)
 	case KEY_7:
 		take_screenshot();
 		break;
+#endif
+#ifdef TRACE_ON
+	case KEY_4:
+		trace_dump();
+		break;
 #endif
 	case KEY_ACON:
 		gint_poweroff(true);
@@ -95,7 +136,7 @@ static unsigned int kbd_getkey(void)
 	case KEY_COMMA:
 		debug_display = 1 - debug_display;
 		return KEY_REDRAW;
-#ifndef FX9860G_G3A
+#ifdef FX9860G
 	case KEY_OPTN:
 		if (!isSlim())
 			t6k11_backlight(-1);
@@ -104,7 +145,7 @@ static unsigned int kbd_getkey(void)
 	}
 	if (debug_display)
 		switch (key) {
-#ifdef FX9860G_G3A
+#ifdef FXCG50
 		case KEY_1:
 			if (debug_r < 31)
 				++debug_r;
@@ -159,22 +200,141 @@ static unsigned int kbd_getkey(void)
 	return key;
 }
 
+static unsigned int kbd_getkey(void)
+{
+	return kbd_getkey_opt(true);
+}
+
+static int game_command(unsigned int key)
+{
+	switch (key) {
+	case KEY_REDRAW:
+	case KEY_RELOAD:
+		return COMMAND_REDRAW;
+	case KEY_MENU:
+		return COMMAND_OSMENU;
+	case KEY_UP:
+		return COMMAND_CURSOR_UP;
+	case KEY_DOWN:
+		return COMMAND_CURSOR_DOWN;
+	case KEY_LEFT:
+		return COMMAND_CURSOR_LEFT;
+	case KEY_RIGHT:
+		return COMMAND_CURSOR_RIGHT;
+	case KEY_SHIFT:
+	case KEY_ALPHA:
+	case KEY_EXE:
+		return COMMAND_SELECT;
+	case KEY_EXIT:
+		return COMMAND_CANCEL;
+	case KEY_F1:
+	case KEY_HELP:
+	case KEY_SETTINGS:
+		return COMMAND_HELP;
+	case KEY_F5:
+	case KEY_PREVTAB:
+		return COMMAND_ROTATE_CCW;
+	case KEY_F6:
+	case KEY_NEXTTAB:
+		return COMMAND_ROTATE_CW;
+	case KEY_ADD:
+	case KEY_RIGHTP:
+		return COMMAND_PUZZLE_NEXT;
+	case KEY_SUB:
+	case KEY_LEFTP:
+		return COMMAND_PUZZLE_PREV;
+	case KEY_F2:
+	case KEY_VARS:
+		return COMMAND_PACKS;
+	case KEY_F3:
+	case KEY_DEL:
+		return COMMAND_UNDO;
+	case KEY_F4:
+		return COMMAND_REDO;
+	case KEY_XOT:
+		return COMMAND_OVERVIEW;
+	case KEY_ARROW:
+		return COMMAND_LEVELS;
+	case KEY_FD:
+		return COMMAND_RECORD;
+	case KEY_FRAC:
+		return COMMAND_CHECK;
+	case KEY_POWER:
+		return COMMAND_BENCH;
+	case KEY_SQUARE:
+		return COMMAND_EDIT;
+	}
+	return -1;
+}
+
 command_t kbd_game(void)
+{
+	while (1) {
+		int command = game_command(kbd_getkey());
+		if (command >= 0)
+			return command;
+	}
+}
+
+/* The next queued game command, or COMMAND_NONE once the queue is empty */
+command_t kbd_game_pending(void)
+{
+	while (1) {
+		unsigned int key = kbd_getkey_opt(false);
+		if (key == (unsigned int)KEY_NONE)
+			return COMMAND_NONE;
+		int command = game_command(key);
+		if (command >= 0)
+			return command;
+	}
+}
+
+command_t kbd_help(void)
+{
+	while (1) {
+		switch (kbd_getkey()) {
+		case KEY_REDRAW:
+			return COMMAND_REDRAW;
+		case KEY_EXIT:
+		case KEY_RELOAD:
+			return COMMAND_CANCEL;
+		case KEY_F1:
+		case KEY_HELP:
+		case KEY_SETTINGS:
+			return COMMAND_HELP;
+		}
+	}
+}
+
+command_t kbd_packs(void)
+{
+	while (1) {
+		switch (kbd_getkey()) {
+		case KEY_REDRAW:
+			return COMMAND_REDRAW;
+		case KEY_UP:
+			return COMMAND_CURSOR_UP;
+		case KEY_DOWN:
+			return COMMAND_CURSOR_DOWN;
+		case KEY_SHIFT:
+		case KEY_ALPHA:
+		case KEY_EXE:
+			return COMMAND_SELECT;
+		case KEY_EXIT:
+		case KEY_F2:
+		case KEY_VARS:
+		case KEY_RELOAD:
+			return COMMAND_CANCEL;
+		}
+	}
+}
+
+command_t kbd_levels(void)
 {
 	while (1) {
 		switch (kbd_getkey()) {
 		case KEY_REDRAW:
 			return COMMAND_REDRAW;
-		case KEY_MENU:
-#ifndef FX9860G_G3A
-			display_menu_return();
-			ignore_keypress = true;
-#endif
-			gint_osmenu();
-#ifdef FX9860G_G3A
-			dupdate();
-#endif
-			return COMMAND_OSMENU;
 		case KEY_UP:
 			return COMMAND_CURSOR_UP;
 		case KEY_DOWN:
@@ -188,44 +348,88 @@ command_t kbd_game(void)
 		case KEY_EXE:
 			return COMMAND_SELECT;
 		case KEY_EXIT:
+		case KEY_ARROW:
+		case KEY_RELOAD:
 			return COMMAND_CANCEL;
-		case KEY_F1:
-		case KEY_HELP:
-		case KEY_SETTINGS:
-			return COMMAND_HELP;
+		}
+	}
+}
+
+/*
+Puzzle editor keys:
+	Arrows: move the cursor
+	EXE: change the token under the cursor to the next type
+	F5/F6: turn it
+	F1/F2/F3: switch whether it moves, rotates, or is a required target
+	+/-: change the number of targets to hit
+	F4: save the puzzle into the pack
+	x: save it as a new puzzle at the end of the pack, and edit that one
+	EXIT: leave the editor, dropping changes not saved
+*/
+command_t kbd_editor(void)
+{
+	while (1) {
+		switch (kbd_getkey()) {
+		case KEY_REDRAW:
+		case KEY_RELOAD:
+			return COMMAND_REDRAW;
+		case KEY_UP:
+			return COMMAND_CURSOR_UP;
+		case KEY_DOWN:
+			return COMMAND_CURSOR_DOWN;
+		case KEY_LEFT:
+			return COMMAND_CURSOR_LEFT;
+		case KEY_RIGHT:
+			return COMMAND_CURSOR_RIGHT;
+		case KEY_SHIFT:
+		case KEY_ALPHA:
+		case KEY_EXE:
+			return COMMAND_EDIT_TYPE;
 		case KEY_F5:
 		case KEY_PREVTAB:
 			return COMMAND_ROTATE_CCW;
 		case KEY_F6:
 		case KEY_NEXTTAB:
 			return COMMAND_ROTATE_CW;
+		case KEY_F1:
+			return COMMAND_EDIT_MOVABLE;
+		case KEY_F2:
+			return COMMAND_EDIT_ROTATABLE;
+		case KEY_F3:
+			return COMMAND_EDIT_REQUIRED;
 		case KEY_ADD:
 		case KEY_RIGHTP:
-			return COMMAND_PUZZLE_NEXT;
+			return COMMAND_EDIT_TARGETS_UP;
 		case KEY_SUB:
 		case KEY_LEFTP:
-			return COMMAND_PUZZLE_PREV;
+			return COMMAND_EDIT_TARGETS_DOWN;
+		case KEY_F4:
+			return COMMAND_EDIT_SAVE;
+		case KEY_MUL:
+			return COMMAND_EDIT_COPY;
+		case KEY_EXIT:
+		case KEY_SQUARE:
+			return COMMAND_CANCEL;
 		}
 	}
 }
 
-command_t kbd_help(void)
+/* Waits for a key press, letting timer and USB wakes go by */
+static void wait_key(void)
 {
-	while (1) {
-		switch (kbd_getkey()) {
-		case KEY_REDRAW:
-			return COMMAND_REDRAW;
-		case KEY_EXIT:
-			return COMMAND_CANCEL;
-		case KEY_F1:
-		case KEY_HELP:
-		case KEY_SETTINGS:
-			return COMMAND_HELP;
-		}
-	}
+	unsigned int key;
+	do
+		key = kbd_getkey();
+	while (key == (unsigned int)KEY_RELOAD ||
+		key == (unsigned int)KEY_NONE);
 }
 
 void kbd_error(void)
 {
-	kbd_getkey();
+	wait_key();
+}
+
+void kbd_wait(void)
+{
+	wait_key();
 }
@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022  Jeffry Johnston
+Copyright (C) 2022, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -33,10 +33,34 @@ typedef enum __attribute__((__packed__)) {
 	COMMAND_ROTATE_CW,
 	COMMAND_PUZZLE_NEXT,
 	COMMAND_PUZZLE_PREV,
-	COMMAND_HELP
+	COMMAND_HELP,
+	COMMAND_PACKS,
+	COMMAND_UNDO,
+	COMMAND_REDO,
+	COMMAND_OVERVIEW,
+	COMMAND_LEVELS,
+	COMMAND_RECORD,
+	COMMAND_CHECK,
+	COMMAND_BENCH,
+	COMMAND_EDIT,
+	COMMAND_EDIT_TYPE,
+	COMMAND_EDIT_MOVABLE,
+	COMMAND_EDIT_ROTATABLE,
+	COMMAND_EDIT_REQUIRED,
+	COMMAND_EDIT_TARGETS_UP,
+	COMMAND_EDIT_TARGETS_DOWN,
+	COMMAND_EDIT_SAVE,
+	COMMAND_EDIT_COPY,
+	COMMAND_NONE
 } command_t;
 
 void kbd_init(void);
+void kbd_osmenu(void);
 command_t kbd_game(void);
+command_t kbd_game_pending(void);
 command_t kbd_help(void);
+command_t kbd_packs(void);
+command_t kbd_levels(void);
+command_t kbd_editor(void);
 void kbd_error(void);
+void kbd_wait(void);
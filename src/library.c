@@ -0,0 +1,306 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "file.h"
+#include "game.h"
+#include "library.h"
+
+#define DIR_MAGIC "LDIR"
+#define DIR_VERSION 1
+
+/*
+LASER.dir caches what the pack menu needs so that startup only has to list
+the LASER*.dat files. An entry is trusted as long as the file size reported
+by the directory listing (stamp) is unchanged; otherwise the pack is opened
+again to read its title and puzzle count, and its LASER*.cfg to count the
+solved puzzles.
+*/
+static struct {
+	char magic[4];
+	uint8_t version;
+	uint8_t count;
+	uint8_t current;
+	uint8_t reserved;
+	pack_t packs[PACK_MAX];
+} dir;
+static int dir_dirty;
+static int loaded;
+static int streamed;
+
+static pack_t found[PACK_MAX];
+static char scratch[PUZZLE_MAX];
+static char filename[PACK_NAME_MAX + 2];
+static const char *error_filename = PUZZLE_FILENAME;
+
+static const char *pack_filename(const pack_t *pack, const char *ext)
+{
+	int i = 0;
+	for (; pack->name[i] && pack->name[i] != '.'; ++i)
+		filename[i] = pack->name[i];
+	strcpy(filename + i, ext);
+	return filename;
+}
+
+static int count_solved(const char *buf, int count)
+{
+	int solved = 0;
+	for (int i = 0; i < count; ++i)
+		if (buf[i] == '1')
+			++solved;
+	return solved;
+}
+
+static int probe_pack(pack_t *pack)
+{
+	error_filename = pack->name;
+	int rc = file_read_pack_info(pack);
+	if (rc)
+		return rc;
+
+	// Untitled packs are named after their file
+	if (!pack->title[0])
+		for (int i = 0; pack->name[i] && pack->name[i] != '.'; ++i)
+			pack->title[i] = pack->name[i];
+
+	pack->solved = 0;
+	if (!file_read_solved(pack, scratch))
+		pack->solved = count_solved(scratch, pack->puzzles);
+	return 0;
+}
+
+static pack_t *find_cached(const char *name)
+{
+	for (int i = 0; i < dir.count; ++i)
+		if (!strcmp(dir.packs[i].name, name))
+			return &dir.packs[i];
+	return NULL;
+}
+
+static void sort_packs(pack_t *packs, int count)
+{
+	for (int i = 1; i < count; ++i) {
+		pack_t pack = packs[i];
+		int j = i;
+		for (; j > 0 && strcmp(packs[j - 1].name, pack.name) > 0; --j)
+			packs[j] = packs[j - 1];
+		packs[j] = pack;
+	}
+}
+
+int library_init(void)
+{
+	// Read the cached directory, starting over if it is missing or stale
+	error_filename = DIR_FILENAME;
+	if (file_read_dir(&dir, sizeof(dir)) ||
+			memcmp(dir.magic, DIR_MAGIC, sizeof(dir.magic)) ||
+			dir.version != DIR_VERSION || dir.count > PACK_MAX ||
+			dir.current >= PACK_MAX) {
+		memset(&dir, 0, sizeof(dir));
+		memcpy(dir.magic, DIR_MAGIC, sizeof(dir.magic));
+		dir.version = DIR_VERSION;
+		dir_dirty = 1;
+	}
+	char current[PACK_NAME_MAX + 2];
+	strcpy(current, dir.current < dir.count ?
+		dir.packs[dir.current].name : PUZZLE_FILENAME);
+
+	// List the packs in storage memory and revalidate by file size
+	error_filename = PUZZLE_FILENAME;
+	int count = file_scan_packs(found, PACK_MAX);
+	sort_packs(found, count);
+	if (count != dir.count)
+		dir_dirty = 1;
+	for (int i = 0; i < count; ++i) {
+		pack_t *cached = find_cached(found[i].name);
+		if (cached && cached->stamp == found[i].stamp) {
+			found[i] = *cached;
+			continue;
+		}
+		int rc = probe_pack(&found[i]);
+		if (rc)
+			return rc;
+		dir_dirty = 1;
+	}
+
+	// Drop files too short to hold a puzzle
+	int packs = 0;
+	for (int i = 0; i < count; ++i)
+		if (found[i].puzzles)
+			dir.packs[packs++] = found[i];
+	dir.count = packs;
+	if (!packs) {
+		error_filename = PUZZLE_FILENAME;
+		return 10;
+	}
+
+	// Return to the pack played last
+	int selected = 0;
+	for (int i = 0; i < packs; ++i)
+		if (!strcmp(dir.packs[i].name, current))
+			selected = i;
+	return library_select(selected);
+}
+
+int library_count(void)
+{
+	return dir.count;
+}
+
+int library_current(void)
+{
+	return dir.current;
+}
+
+pack_t *library_get(int i)
+{
+	return &dir.packs[i];
+}
+
+int library_select(int i)
+{
+	// Keep the progress made in the pack being left
+	int rc = library_save();
+	if (rc)
+		return rc;
+
+	pack_t *pack = &dir.packs[i];
+	error_filename = pack->name;
+	rc = file_read_pack(pack, game_get_puzzles());
+	if (rc)
+		return rc;
+	loaded = 1;
+	streamed = 0;
+
+	// Read in-progress puzzles and solved status
+	if (file_read_snapshots(pack, game_get_snapshots()))
+		memset(game_get_snapshots(), 0xff, SNAPSHOT_BYTES);
+	rc = file_read_solved(pack, game_get_solved());
+	rc = game_init(pack->bytes, rc);
+	if (rc)
+		return rc;
+
+	// The solved count of the current pack is only written back here
+	int solved = game_get_solved_count();
+	if (dir.current != i || pack->solved != solved)
+		dir_dirty = 1;
+	dir.current = i;
+	pack->solved = solved;
+	if (dir_dirty) {
+		error_filename = DIR_FILENAME;
+		rc = file_write_dir(&dir, sizeof(dir));
+		if (rc)
+			return rc;
+		dir_dirty = 0;
+	}
+	return 0;
+}
+
+int library_write_solved(void)
+{
+	if (streamed)
+		return 0;
+	pack_t *pack = &dir.packs[dir.current];
+	pack->solved = game_get_solved_count();
+	dir_dirty = 1;
+	error_filename = pack_filename(pack, SOLVED_EXT);
+	return file_write_solved(pack, game_get_solved());
+}
+
+/*
+Snapshots are only kept in RAM while browsing puzzles, and written when
+leaving the pack or the add-in.
+*/
+int library_save(void)
+{
+	if (!loaded)
+		return 0;
+	game_snapshot();
+	if (!game_snapshots_dirty())
+		return 0;
+	pack_t *pack = &dir.packs[dir.current];
+	error_filename = pack_filename(pack, SNAPSHOT_EXT);
+	int rc = file_write_snapshots(pack, game_get_snapshots());
+	if (rc)
+		return rc;
+	game_snapshots_saved();
+	return 0;
+}
+
+/* A play session recorded in the current pack, see record.c */
+int library_write_record(const uint8_t *data, int size)
+{
+	if (streamed)
+		return 0;
+	pack_t *pack = &dir.packs[dir.current];
+	error_filename = pack_filename(pack, RECORD_EXT);
+	return file_write_record(pack, data, size);
+}
+
+/*
+The puzzles as changed in the editor replace the pack file, as a raw pack:
+see game_edit_save(). The file size changes, so the pack is probed again at
+the next startup.
+*/
+int library_write_pack(void)
+{
+	if (streamed)
+		return 0;
+	pack_t *pack = &dir.packs[dir.current];
+	int count = game_get_puzzle_count();
+	int size = BYTES_PER_PUZZLE * count;
+
+	// Untitled packs were named after their file, which is no title to keep
+	int stem = 0;
+	while (pack->name[stem] && pack->name[stem] != '.')
+		++stem;
+	const char *title = pack->title;
+	if (!strncmp(title, pack->name, stem) && !title[stem])
+		title = "";
+
+	error_filename = pack->name;
+	int rc = file_write_pack(pack, game_get_puzzles(), size, title);
+	if (rc)
+		return rc;
+	pack->stamp = 0;
+	pack->bytes = size;
+	pack->puzzles = count;
+	return library_write_solved();
+}
+
+/*
+A pack pushed over USB replaced the puzzles in RAM: its progress is never
+written, and the current pack can be selected again to get back to it.
+*/
+void library_stream(void)
+{
+	loaded = 0;
+	streamed = 1;
+}
+
+int library_is_streamed(void)
+{
+	return streamed;
+}
+
+const char *library_filename(void)
+{
+	return error_filename;
+}
@@ -0,0 +1,54 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define PACK_MAX 16
+#define PACK_NAME_MAX 12 /* 8.3 file name */
+#define PACK_TITLE_MAX 23
+#define PACK_PATTERN "LASER*.dat"
+#define DIR_FILENAME "LASER.dir"
+#define SOLVED_EXT ".cfg"
+#define SNAPSHOT_EXT ".sav"
+#define RECORD_EXT ".rec"
+
+typedef struct {
+	uint32_t stamp;
+	uint16_t bytes;
+	uint8_t puzzles;
+	uint8_t solved;
+	char name[PACK_NAME_MAX + 2];
+	char title[PACK_TITLE_MAX + 1];
+} pack_t;
+
+int library_init(void);
+int library_count(void);
+int library_current(void);
+pack_t *library_get(int i);
+int library_select(int i);
+int library_write_solved(void);
+int library_save(void);
+int library_write_record(const uint8_t *data, int size);
+int library_write_pack(void);
+void library_stream(void);
+int library_is_streamed(void);
+const char *library_filename(void);
@@ -0,0 +1,99 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#ifndef FX9860G_G3A
+#include <gint/usb.h>
+#include <gint/usb-ff-bulk.h>
+#endif
+#include "game.h"
+#include "library.h"
+#include "link.h"
+
+/*
+How to push a puzzle pack while playing:
+1. Run: tools/laser-push.py PACK.dat
+2. The pack replaces the puzzles in RAM and the current puzzle is reloaded
+
+The message is an fxlink message with application "laser" and type "pack",
+holding the pack file as is.
+*/
+static char pack[PUZZLE_BYTES + PACK_TITLE_MAX];
+static int pack_size;
+
+#ifndef FX9860G_G3A
+static int read_pack(int size)
+{
+	int pipe = usb_ff_bulk_input();
+	int done = 0;
+	while (done < size) {
+		int rc = usb_read_sync(pipe, pack + done, size - done, false);
+		if (rc <= 0)
+			return 1;
+		done += rc;
+	}
+	return 0;
+}
+#endif
+
+int link_poll(void)
+{
+#ifndef FX9860G_G3A
+	usb_fxlink_header_t header;
+	if (!usb_is_open() || !usb_fxlink_handle_messages(&header))
+		return 0;
+	if (strncmp(header.application, LINK_APPLICATION, 16) ||
+			strncmp(header.type, LINK_TYPE_PACK, 16)) {
+		usb_fxlink_drop_transaction();
+		return 0;
+	}
+	if (header.size > sizeof(pack)) {
+		usb_fxlink_drop_transaction();
+		link_reply("laser: pack too large\n");
+		return 0;
+	}
+	if (read_pack(header.size)) {
+		link_reply("laser: pack transfer failed\n");
+		return 0;
+	}
+	pack_size = header.size;
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+int link_take(char **data)
+{
+	int size = pack_size;
+	*data = pack;
+	pack_size = 0;
+	return size;
+}
+
+void link_reply(const char *text)
+{
+#ifndef FX9860G_G3A
+	if (usb_is_open())
+		usb_fxlink_text(text, strlen(text));
+#else
+	(void)text;
+#endif
+}
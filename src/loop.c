@@ -0,0 +1,189 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Event loop that runs while waiting for keys. A hardware timer ticks every
+LOOP_TICK_US: timers registered with loop_timer() run on the ticks, and
+between keys, idle tasks run in slices of about LOOP_SLICE_US. Keys are
+polled after every slice, so a key waits at most one slice plus one idle
+step. Once no idle task has work left, the loop sleeps until the next key
+or tick.
+
+Everything runs in the main program, the interrupt only counts ticks. The G3A
+build has no libprof (see timing.c) to time the slices, so it runs one idle
+step per slice.
+*/
+
+#include <gint/timer.h>
+#ifndef FX9860G_G3A
+#include <libprof.h>
+#endif
+#include "loop.h"
+#include "trace.h"
+
+typedef struct {
+	loop_timer_fn fn;
+	int period;
+	int due;
+	int running;
+} timer_slot_t;
+
+static volatile int tick;
+static volatile int tick_wake;
+static timer_slot_t timers[LOOP_TIMER_MAX];
+static int timer_count;
+static loop_idle_fn idles[LOOP_IDLE_MAX];
+static int idle_count;
+static int idle_pending;
+
+static int on_tick(void)
+{
+	++tick;
+	tick_wake = 1;
+	return TIMER_CONTINUE;
+}
+
+void loop_init(void)
+{
+	int timer = timer_configure(TIMER_ANY, LOOP_TICK_US,
+					GINT_CALL(on_tick));
+	if (timer >= 0)
+		timer_start(timer);
+}
+
+/*
+Registers a timer and returns its id. A periodic timer runs every period
+ticks, while a timer with period 0 only runs once per loop_timer_start().
+*/
+int loop_timer(loop_timer_fn fn, int period)
+{
+	if (timer_count == LOOP_TIMER_MAX)
+		return -1;
+	timer_slot_t *timer = &timers[timer_count];
+	timer->fn = fn;
+	timer->period = period;
+	timer->due = tick + period;
+	timer->running = period > 0;
+	return timer_count++;
+}
+
+/* Runs a timer once ticks from now, instead of when it was due */
+void loop_timer_start(int id, int ticks)
+{
+	if (id < 0)
+		return;
+	timers[id].due = tick + ticks;
+	timers[id].running = 1;
+}
+
+void loop_idle(loop_idle_fn fn)
+{
+	if (idle_count < LOOP_IDLE_MAX)
+		idles[idle_count++] = fn;
+	idle_pending = 1;
+}
+
+/* Lets the idle tasks look for new work */
+void loop_wake(void)
+{
+	idle_pending = 1;
+}
+
+/* Runs the timers that are due, returns nonzero if one ends the wait */
+static int run_timers(void)
+{
+	int wake = 0;
+	int now = tick;
+	for (int i = 0; i < timer_count; ++i) {
+		timer_slot_t *timer = &timers[i];
+		if (!timer->running || now - timer->due < 0)
+			continue;
+		if (timer->period)
+			timer->due = now + timer->period;
+		else
+			timer->running = 0;
+		wake |= timer->fn();
+	}
+	return wake;
+}
+
+/* One step of every idle task, returns nonzero if any did some work */
+static int run_idle_step(void)
+{
+	int busy = 0;
+	for (int i = 0; i < idle_count; ++i)
+		busy |= idles[i]();
+	return busy;
+}
+
+/* Runs idle steps for about one slice, returns 0 once they are all done */
+static int run_idle_slice(void)
+{
+	if (!idle_pending)
+		return 0;
+#ifndef FX9860G_G3A
+	TRACE_ADD(TRACE_IDLE, TRACE_BEGIN);
+	prof_t slice = prof_make();
+	while (1) {
+		prof_enter(slice);
+		int busy = run_idle_step();
+		prof_leave(slice);
+		if (!busy)
+			idle_pending = 0;
+		if (!busy || prof_time(slice) >= LOOP_SLICE_US)
+			break;
+	}
+	TRACE_ADD(TRACE_IDLE, TRACE_END);
+	return idle_pending;
+#else
+	if (!run_idle_step())
+		idle_pending = 0;
+	return idle_pending;
+#endif
+}
+
+/*
+Returns the next key event. Without wait, it returns KEYEV_NONE if no key is
+queued. With wait, it only returns KEYEV_NONE when a timer ends the wait.
+*/
+key_event_t loop_wait(bool wait)
+{
+	key_event_t event;
+	while (1) {
+		int wake = run_timers();
+
+		// Poll for a queued key
+		tick_wake = 1;
+		event = getkey_opt(GETKEY_BACKLIGHT, &tick_wake);
+		if (event.type != KEYEV_NONE || !wait || wake)
+			break;
+
+		// Sleep until the next key or tick once the idle work is done
+		if (!run_idle_slice()) {
+			tick_wake = 0;
+			event = getkey_opt(GETKEY_BACKLIGHT, &tick_wake);
+			if (event.type != KEYEV_NONE)
+				break;
+		}
+	}
+	if (event.type != KEYEV_NONE)
+		idle_pending = 1;
+	return event;
+}
@@ -0,0 +1,42 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <gint/keyboard.h>
+
+#define LOOP_TICK_US 50000
+#define LOOP_SLICE_US 5000
+#define LOOP_TIMER_MAX 4
+#define LOOP_IDLE_MAX 4
+
+/* Returns nonzero to end the wait for a key */
+typedef int (*loop_timer_fn)(void);
+
+/* Does one short step of work, returns 0 once there is nothing left to do */
+typedef int (*loop_idle_fn)(void);
+
+void loop_init(void);
+int loop_timer(loop_timer_fn fn, int period);
+void loop_timer_start(int id, int ticks);
+void loop_idle(loop_idle_fn fn);
+void loop_wake(void);
+key_event_t loop_wait(bool wait);
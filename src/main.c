@@ -1,6 +1,6 @@
 /*
 Laser Logic
-Copyright (C) 2022, 2025  Jeffry Johnston
+Copyright (C) 2022, 2025, 2026  Jeffry Johnston
 
 This file is part of Laser Logic.
 
@@ -18,12 +18,23 @@ You should have received a copy of the GNU General Public License
 along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <stdbool.h>
 #include <gint/gint.h>
 #include <gint/hardware.h>
+#include "bench.h"
+#include "board.h"
 #include "display.h"
-#include "file.h"
+#include "editor.h"
 #include "game.h"
 #include "kbd.h"
+#include "library.h"
+#include "link.h"
+#include "loop.h"
+#include "record.h"
+#include "timing.h"
+#include "trace.h"
+
+#define SAVE_IDLE_TICKS (10000000 / LOOP_TICK_US)
 
 static int help2(void)
 {
@@ -57,82 +68,371 @@ static void help1(void)
 	}
 }
 
-static void play_game(void)
+static bool overview;
+
+static void levels(void)
 {
-	// Read puzzles
-	int rc = file_read_puzzles(game_get_puzzles());
-	if (rc) {
-		display_file_error(rc, "reading", PUZZLE_FILENAME);
-		kbd_error();
-		return;
+	int sel = game_get_puzzle_index();
+	int count = game_get_puzzle_count();
+	while (1) {
+		display_levels(sel);
+		switch(kbd_levels()) {
+		case COMMAND_CURSOR_UP:
+			if (sel >= THUMB_COLS)
+				sel -= THUMB_COLS;
+			break;
+		case COMMAND_CURSOR_DOWN:
+			if (sel + THUMB_COLS < count)
+				sel += THUMB_COLS;
+			break;
+		case COMMAND_CURSOR_LEFT:
+			if (sel > 0)
+				--sel;
+			break;
+		case COMMAND_CURSOR_RIGHT:
+			if (sel < count - 1)
+				++sel;
+			break;
+		case COMMAND_SELECT:
+			game_goto_puzzle(sel);
+			record_goto(sel);
+			return;
+		case COMMAND_CANCEL:
+			return;
+		default:
+			break;
+		}
 	}
+}
 
-	// Read solved status
-	rc = file_read_solved(game_get_solved());
+static void file_error(int rc)
+{
+	display_file_error(rc, rc < 20 ? "reading" : "writing",
+				library_filename());
+	kbd_error();
+}
 
-	rc = game_init(rc);
-	if (rc) {
-		display_file_error(rc, "reading", SOLVED_FILENAME);
-		kbd_error();
-		return;
+static int packs(void)
+{
+	int sel = library_current();
+	while (1) {
+		display_packs(sel);
+		switch(kbd_packs()) {
+		case COMMAND_CURSOR_UP:
+			if (sel > 0)
+				--sel;
+			break;
+		case COMMAND_CURSOR_DOWN:
+			if (sel < library_count() - 1)
+				++sel;
+			break;
+		case COMMAND_SELECT:
+			if (sel == library_current() && !library_is_streamed())
+				return 0;
+			return library_select(sel);
+		case COMMAND_CANCEL:
+			return 0;
+		default:
+			break;
+		}
 	}
+}
 
-	display_init_mono(true);
-	while (1) {
-		if (game_laser()) {
-			int rc = file_write_solved(game_get_solved());
-			if (rc) {
-				display_file_error(rc, "writing",
-							SOLVED_FILENAME);
-				kbd_error();
-				return;
-			}
-			display_init_mono(true);;
+/* Traces the beam if anything moved, and records a solve */
+static int trace(void)
+{
+	timing_enter(TIMING_LASER);
+	int is_solved = game_laser();
+	timing_leave(TIMING_LASER);
+	record_trace();
+	if (is_solved) {
+		record_check();
+		int rc = library_write_solved();
+		if (rc) {
+			file_error(rc);
+			return 1;
 		}
+	}
+	return 0;
+}
 
-		display_game();
+/*
+Writes the snapshots once no key was pressed for SAVE_IDLE_TICKS. A failed
+write is left to be reported when leaving the pack or the add-in.
+*/
+static int save_timer = -1;
 
-		switch(kbd_game()) {
-		case COMMAND_OSMENU:
-			if (gint[HWCALC] == HWCALC_FXCG100)
-				return;
+static int autosave(void)
+{
+	library_save();
+	return 0;
+}
+
+/* Stops recording and writes the session out */
+static int stop_record(void)
+{
+	if (!record_is_on())
+		return 0;
+	record_stop();
+	int size;
+	const uint8_t *data = record_data(&size);
+	int rc = library_write_record(data, size);
+	if (rc)
+		file_error(rc);
+	return rc;
+}
+
+/*
+Edits the current puzzle until EXIT, see kbd_editor(). Returns nonzero if a
+file could not be written.
+*/
+static int edit(void)
+{
+	editor_start();
+	while (1) {
+		if (trace())
 			break;
+		display_game();
+		command_t command = kbd_editor();
+		switch (command) {
 		case COMMAND_CURSOR_UP:
 			game_cursor_row(-1);
-			break;
+			continue;
 		case COMMAND_CURSOR_DOWN:
 			game_cursor_row(1);
-			break;
+			continue;
 		case COMMAND_CURSOR_LEFT:
 			game_cursor_col(-1);
-			break;
+			continue;
 		case COMMAND_CURSOR_RIGHT:
 			game_cursor_col(1);
-			break;
-		case COMMAND_SELECT:
-			game_select_token();
-			break;
-		case COMMAND_CANCEL:
-			game_deselect_token();
+			continue;
+		case COMMAND_EDIT_TYPE:
+			game_edit_type();
 			break;
 		case COMMAND_ROTATE_CCW:
-			game_rotate_token(-1);
+			game_edit_rotate(-1);
 			break;
 		case COMMAND_ROTATE_CW:
-			game_rotate_token(1);
+			game_edit_rotate(1);
 			break;
-		case COMMAND_PUZZLE_NEXT:
-			game_next_puzzle();
+		case COMMAND_EDIT_MOVABLE:
+			game_edit_movable();
 			break;
-		case COMMAND_PUZZLE_PREV:
-			game_previous_puzzle();
+		case COMMAND_EDIT_ROTATABLE:
+			game_edit_rotatable();
 			break;
-		case COMMAND_HELP:
-			help1();
+		case COMMAND_EDIT_REQUIRED:
+			game_edit_required();
 			break;
-		default:
+		case COMMAND_EDIT_TARGETS_UP:
+			game_edit_targets(1);
+			break;
+		case COMMAND_EDIT_TARGETS_DOWN:
+			game_edit_targets(-1);
 			break;
+		case COMMAND_EDIT_SAVE:
+		case COMMAND_EDIT_COPY:
+			// Nothing is saved without a laser or room in the pack,
+			// and a pack pushed over USB only changes in RAM
+			if (game_edit_save(command == COMMAND_EDIT_COPY)) {
+				editor_saved(0);
+				continue;
+			}
+			editor_saved(!library_is_streamed());
+			int rc = library_write_pack();
+			if (rc) {
+				file_error(rc);
+				editor_stop();
+				return rc;
+			}
+			continue;
+		case COMMAND_CANCEL:
+			editor_stop();
+			return 0;
+		default:
+			continue;
 		}
+		editor_changed();
+	}
+	editor_stop();
+	return 1;
+}
+
+/*
+Applies a game command. Returns 1 if queued commands may follow before the
+next frame, 0 if the screen must be redrawn first, or -1 to quit.
+*/
+static int game_command(command_t command)
+{
+	int rc;
+
+	// Commands that leave the puzzle must not skip a solve still untraced
+	switch (command) {
+	case COMMAND_OSMENU:
+	case COMMAND_LEVELS:
+	case COMMAND_PUZZLE_NEXT:
+	case COMMAND_PUZZLE_PREV:
+	case COMMAND_PACKS:
+	case COMMAND_CHECK:
+	case COMMAND_BENCH:
+	case COMMAND_EDIT:
+		if (trace())
+			return -1;
+		break;
+	default:
+		break;
+	}
+
+	switch (command) {
+	case COMMAND_OSMENU:
+		rc = library_save();
+		if (rc) {
+			file_error(rc);
+			return -1;
+		}
+		kbd_osmenu();
+		if (gint[HWCALC] == HWCALC_FXCG100)
+			return -1;
+		return 0;
+	case COMMAND_CURSOR_UP:
+		game_cursor_row(-1);
+		break;
+	case COMMAND_CURSOR_DOWN:
+		game_cursor_row(1);
+		break;
+	case COMMAND_CURSOR_LEFT:
+		game_cursor_col(-1);
+		break;
+	case COMMAND_CURSOR_RIGHT:
+		game_cursor_col(1);
+		break;
+	case COMMAND_SELECT:
+		game_select_token();
+		break;
+	case COMMAND_CANCEL:
+		game_deselect_token();
+		break;
+	case COMMAND_ROTATE_CCW:
+		game_rotate_token(-1);
+		break;
+	case COMMAND_ROTATE_CW:
+		game_rotate_token(1);
+		break;
+	case COMMAND_UNDO:
+		game_undo();
+		break;
+	case COMMAND_REDO:
+		game_redo();
+		break;
+	case COMMAND_OVERVIEW:
+		overview = !overview;
+		break;
+	case COMMAND_LEVELS:
+		levels();
+		return 0;
+	case COMMAND_PUZZLE_NEXT:
+		game_next_puzzle();
+		break;
+	case COMMAND_PUZZLE_PREV:
+		game_previous_puzzle();
+		break;
+	case COMMAND_HELP:
+		help1();
+		return 0;
+	case COMMAND_PACKS:
+		if (stop_record())
+			return -1;
+		rc = packs();
+		if (rc) {
+			file_error(rc);
+			return -1;
+		}
+		return 0;
+	case COMMAND_RECORD:
+		if (record_is_on()) {
+			if (stop_record())
+				return -1;
+		} else {
+			record_start();
+		}
+		return 0;
+	case COMMAND_CHECK:
+		record_check();
+		return 1;
+	case COMMAND_BENCH:
+		if (stop_record())
+			return -1;
+		bench_t bench;
+		if (!bench_run(&bench)) {
+			display_bench(&bench);
+			kbd_wait();
+		}
+		return 0;
+	case COMMAND_EDIT:
+		if (stop_record() || edit())
+			return -1;
+		return 0;
+	case COMMAND_REDRAW:
+		return 0;
+	default:
+		break;
+	}
+	record_command(command);
+	loop_timer_start(save_timer, SAVE_IDLE_TICKS);
+	return 1;
+}
+
+static void play_game(void)
+{
+	// Find puzzle packs and load the one played last
+	int rc = library_init();
+	if (rc) {
+		file_error(rc);
+		return;
+	}
+	save_timer = loop_timer(autosave, 0);
+	loop_idle(board_prefetch);
+	loop_idle(editor_check);
+	loop_timer(editor_poll, EDITOR_POLL_TICKS);
+
+	while (1) {
+		// Swap in a puzzle pack sent over USB
+		char *pack;
+		int size = link_take(&pack);
+		if (size) {
+			if (stop_record())
+				return;
+			rc = library_save();
+			if (rc) {
+				file_error(rc);
+				return;
+			}
+			if (game_load_pack(pack, size)) {
+				link_reply("laser: pack rejected\n");
+			} else {
+				library_stream();
+				loop_wake();
+				link_reply("laser: pack loaded\n");
+			}
+		}
+
+		if (trace())
+			return;
+
+		if (overview)
+			display_overview();
+		else
+			display_game();
+
+		// Apply every queued command before tracing and drawing again
+		command_t command = kbd_game();
+		do {
+			rc = game_command(command);
+			if (rc < 0)
+				return;
+		} while (rc && (command = kbd_game_pending()) != COMMAND_NONE);
+		timing_leave(TIMING_KEY);
 	}
 }
 
@@ -140,6 +440,9 @@ int main(void)
 {
 	kbd_init();
 	display_init();
+	timing_init();
+	TRACE_INIT();
+	loop_init();
 	play_game();
 	return 0;
 }
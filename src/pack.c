@@ -0,0 +1,180 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "game.h"
+#include "library.h"
+#include "pack.h"
+#include "range.h"
+
+/*
+Packs come in two formats. A raw pack is the puzzle records one after the
+other, as described above load_puzzle() in game.c. A compressed pack is:
+	4 bytes: "LZP1"
+	1 byte: puzzle count
+	1 byte: title size (T)
+	1 byte: puzzles per block (B)
+	1 byte: reserved
+	T bytes: title
+	2 bytes per block: offset of the block in the file (big-endian)
+	Blocks
+
+Each block is a separate stream of the range coder in range.c, so any
+puzzle can be reached by decoding at most B records. Every record is coded
+against the one before it in the block, which starts out as all zeroes;
+unused pieces (TOKEN_NONE) are stored as zeroes:
+	ID: same as the previous ID + 1, or 8 raw bits
+	TARGETS: same as before, or 8 raw bits
+	For each of the 11 pieces: same as before, or:
+		DATA: same as before, or TYPE (3 bits) then the upper 5 bits
+		LOC: same as before, or 5 bits (not coded when TYPE is NONE)
+tools/laser-pack.py writes compressed packs.
+*/
+typedef struct {
+	uint16_t id;
+	uint16_t targets;
+	uint16_t piece[TOKEN_COUNT];
+	uint16_t data;
+	uint16_t type[1 << 3];
+	uint16_t flags[1 << 5];
+	uint16_t loc;
+	uint16_t locs[1 << 5];
+} model_t;
+
+typedef struct {
+	range_t rc;
+	model_t model;
+} decoder_t;
+
+static const uint8_t *pack_data;
+static int pack_size;
+static int packed;
+static int per_block;
+static const uint8_t *offsets;
+
+// The last decoded record, to carry on from when browsing in order
+static decoder_t decoder;
+static char record[BYTES_PER_PUZZLE];
+static int decoded = -1;
+
+static void start_block(decoder_t *dec, int block, char *rec)
+{
+	const uint8_t *offset = offsets + 2 * block;
+	range_start(&dec->rc, pack_data + ((offset[0] << 8) | offset[1]),
+		pack_data + pack_size);
+	range_probs((uint16_t *)&dec->model, sizeof(model_t) / sizeof(uint16_t));
+	memset(rec, 0, BYTES_PER_PUZZLE);
+}
+
+static void decode_record(decoder_t *dec, char *rec)
+{
+	range_t *rc = &dec->rc;
+	model_t *model = &dec->model;
+	uint8_t *p = (uint8_t *)rec;
+	if (range_bit(rc, &model->id))
+		p[0] = range_raw(rc, 8);
+	else
+		++p[0];
+	if (range_bit(rc, &model->targets))
+		p[1] = range_raw(rc, 8);
+	for (int i = 0; i < TOKEN_COUNT; ++i) {
+		uint8_t *piece = p + 2 + 2 * i;
+		if (!range_bit(rc, &model->piece[i]))
+			continue;
+		if (range_bit(rc, &model->data)) {
+			int type = range_tree(rc, model->type, 3);
+			piece[1] = (range_tree(rc, model->flags, 5) << 3) | type;
+		}
+		if ((piece[1] & 0x07) == TOKEN_NONE)
+			piece[0] = 0;
+		else if (range_bit(rc, &model->loc))
+			piece[0] = range_tree(rc, model->locs, 5);
+	}
+}
+
+/*
+Finds out from the first bytes of a pack file (up to PACK_HEAD_MAX) how many
+puzzles it holds, how many bytes to load and where its title is.
+*/
+int pack_info(const char *head, int size, pack_info_t *info)
+{
+	const uint8_t *p = (const uint8_t *)head;
+	if (size < PACK_HEAD_BYTES || memcmp(head, PACK_MAGIC, 4)) {
+		info->count = size / BYTES_PER_PUZZLE;
+		if (info->count > PUZZLE_MAX)
+			info->count = PUZZLE_MAX;
+		info->bytes = BYTES_PER_PUZZLE * info->count;
+		info->title_size = size % BYTES_PER_PUZZLE;
+		info->title_offset = size - info->title_size;
+		return info->count;
+	}
+	info->count = p[4] <= PUZZLE_MAX ? p[4] : PUZZLE_MAX;
+	info->bytes = size;
+	info->title_offset = PACK_HEAD_BYTES;
+	info->title_size = p[5] <= PACK_TITLE_MAX ? p[5] : PACK_TITLE_MAX;
+	if (!p[6] || size > PUZZLE_BYTES)
+		info->count = 0;
+	return info->count;
+}
+
+/* Returns the number of puzzles in the pack, or 0 if it is unusable */
+int pack_open(const char *pack, int size)
+{
+	pack_info_t info;
+	int count = pack_info(pack, size, &info);
+
+	pack_data = (const uint8_t *)pack;
+	pack_size = size;
+	packed = !memcmp(pack, PACK_MAGIC, 4) && size >= PACK_HEAD_BYTES;
+	decoded = -1;
+	if (!packed || !count)
+		return count;
+
+	per_block = pack_data[6];
+	offsets = pack_data + PACK_HEAD_BYTES + pack_data[5];
+	int blocks = (count + per_block - 1) / per_block;
+	if (offsets + 2 * blocks > pack_data + size)
+		return 0;
+	return count;
+}
+
+/* Whether the open pack is compressed, so its records cannot be changed */
+int pack_is_compressed(void)
+{
+	return packed;
+}
+
+const char *pack_record(int i)
+{
+	if (!packed)
+		return (const char *)pack_data + BYTES_PER_PUZZLE * i;
+
+	// Carry on from the last record if it is in the same block
+	int block = i / per_block;
+	if (decoded < 0 || decoded > i || decoded / per_block != block) {
+		start_block(&decoder, block, record);
+		decoded = block * per_block - 1;
+	}
+	while (decoded < i) {
+		decode_record(&decoder, record);
+		++decoded;
+	}
+	return record;
+}
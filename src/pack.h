@@ -0,0 +1,37 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define PACK_MAGIC "LZP1"
+#define PACK_HEAD_BYTES 8
+#define PACK_HEAD_MAX 32
+
+typedef struct {
+	int count;
+	int bytes;
+	int title_offset;
+	int title_size;
+} pack_info_t;
+
+int pack_info(const char *head, int size, pack_info_t *info);
+int pack_open(const char *pack, int size);
+int pack_is_compressed(void);
+const char *pack_record(int i);
@@ -0,0 +1,102 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Adaptive binary range decoder, as in LZMA, shared by compressed packs and
+sprites. Each probability is the chance of a 0 bit out of 1 << RANGE_PROB_BITS
+and moves 1/32 of the way towards every bit decoded with it. Input past the
+end reads as zeroes. The encoder is in tools/laser-pack.py.
+*/
+
+#include "range.h"
+
+#define PROB_MOVE 5
+#define RANGE_TOP (1UL << 24)
+
+static int next_byte(range_t *rc)
+{
+	return rc->p < rc->end ? *rc->p++ : 0;
+}
+
+static void normalize(range_t *rc)
+{
+	if (rc->range < RANGE_TOP) {
+		rc->range <<= 8;
+		rc->code = (rc->code << 8) | next_byte(rc);
+	}
+}
+
+void range_start(range_t *rc, const uint8_t *p, const uint8_t *end)
+{
+	rc->p = p < end ? p : end;
+	rc->end = end;
+	rc->range = 0xffffffff;
+	rc->code = 0;
+	for (int i = 0; i < 5; ++i)
+		rc->code = (rc->code << 8) | next_byte(rc);
+}
+
+void range_probs(uint16_t *probs, int count)
+{
+	for (int i = 0; i < count; ++i)
+		probs[i] = RANGE_PROB_INIT;
+}
+
+int range_bit(range_t *rc, uint16_t *prob)
+{
+	uint32_t bound = (rc->range >> RANGE_PROB_BITS) * *prob;
+	int bit;
+	if (rc->code < bound) {
+		rc->range = bound;
+		*prob += ((1 << RANGE_PROB_BITS) - *prob) >> PROB_MOVE;
+		bit = 0;
+	} else {
+		rc->range -= bound;
+		rc->code -= bound;
+		*prob -= *prob >> PROB_MOVE;
+		bit = 1;
+	}
+	normalize(rc);
+	return bit;
+}
+
+/* Bits at even odds, most significant first */
+int range_raw(range_t *rc, int bits)
+{
+	int value = 0;
+	while (bits--) {
+		rc->range >>= 1;
+		int bit = rc->code >= rc->range;
+		if (bit)
+			rc->code -= rc->range;
+		value = (value << 1) | bit;
+		normalize(rc);
+	}
+	return value;
+}
+
+/* A value of bits bits, each coded with the bits above it as context */
+int range_tree(range_t *rc, uint16_t *probs, int bits)
+{
+	int m = 1;
+	for (int i = 0; i < bits; ++i)
+		m = (m << 1) | range_bit(rc, &probs[m]);
+	return m - (1 << bits);
+}
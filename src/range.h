@@ -0,0 +1,39 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define RANGE_PROB_BITS 11
+#define RANGE_PROB_INIT (1 << (RANGE_PROB_BITS - 1))
+
+typedef struct {
+	const uint8_t *p;
+	const uint8_t *end;
+	uint32_t range;
+	uint32_t code;
+} range_t;
+
+void range_start(range_t *rc, const uint8_t *p, const uint8_t *end);
+void range_probs(uint16_t *probs, int count);
+int range_bit(range_t *rc, uint16_t *prob);
+int range_raw(range_t *rc, int bits);
+int range_tree(range_t *rc, uint16_t *probs, int bits);
@@ -0,0 +1,192 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Records the game commands of a play session, to replay them without a
+calculator (see host/laser-replay.c):
+	4 bytes
+	-------
+	MAGIC "LZR1"
+
+	1 byte
+	------
+	PUZZLE INDEX when recording started
+
+	1 byte
+	------
+	PUZZLE COUNT of the pack
+
+	2 bytes
+	-------
+	N = snapshot bytes, little endian
+
+	PUZZLE_MAX bytes
+	----------------
+	SOLVED flags, '0' or '1'
+
+	N bytes
+	-------
+	SNAPSHOTS, as in game.c
+
+	Entries until the end:
+		1 byte
+		------
+		7     | 6 5  | 4 3 2 1 0
+		TRACE | KIND | DATA
+		TRACE: game_laser() ran after this entry
+		KIND 0: a command_t in DATA
+		KIND 1: went to the puzzle index in the next byte
+		KIND 2: checkpoint, the next 6 bytes are the state after the last
+			trace: puzzle index, targets hit, solved, number of paths,
+			and the beam hash, little endian
+		KIND 3: padding to an even size
+
+The puzzle is traced once before the first entry. Recording starts the
+current puzzle over from its snapshot, so that a replay loads it the same way.
+Once the buffer is full, it keeps what fits and records nothing more until it
+is stopped and written out.
+*/
+
+#include <string.h>
+#include "record.h"
+
+static uint8_t data[RECORD_BYTES];
+static int data_used;
+static int last_entry = -1;
+static int recording;
+static int full;
+
+static int append(const uint8_t *entry, int size)
+{
+	if (full || data_used + size > RECORD_BYTES) {
+		full = 1;
+		return 0;
+	}
+	last_entry = data_used;
+	memcpy(data + data_used, entry, size);
+	data_used += size;
+	return 1;
+}
+
+void record_start(void)
+{
+	game_reload_puzzle();
+	int snapshot_bytes = game_get_snapshot_bytes();
+	memcpy(data, RECORD_MAGIC, 4);
+	data[4] = game_get_puzzle_index();
+	data[5] = game_get_puzzle_count();
+	data[6] = snapshot_bytes & 0xff;
+	data[7] = snapshot_bytes >> 8;
+	memcpy(data + 8, game_get_solved(), PUZZLE_MAX);
+	memcpy(data + RECORD_HEAD_BYTES, game_get_snapshots(), snapshot_bytes);
+	data_used = RECORD_HEAD_BYTES + snapshot_bytes;
+	last_entry = -1;
+	recording = 1;
+	full = 0;
+}
+
+void record_stop(void)
+{
+	recording = 0;
+}
+
+int record_is_on(void)
+{
+	return recording;
+}
+
+/* Whether the log ran out of room and entries are being dropped */
+int record_is_full(void)
+{
+	return recording && full;
+}
+
+void record_command(command_t command)
+{
+	uint8_t entry = RECORD_COMMAND | command;
+	if (recording)
+		append(&entry, 1);
+}
+
+void record_goto(int i)
+{
+	uint8_t entry[2] = {RECORD_GOTO, i};
+	if (recording)
+		append(entry, 2);
+}
+
+/* Marks that the beam was traced after the last entry */
+void record_trace(void)
+{
+	if (recording && !full && last_entry >= 0)
+		data[last_entry] |= RECORD_TRACE;
+}
+
+void record_check(void)
+{
+	if (!recording)
+		return;
+	record_check_t check;
+	record_state(&check);
+	uint8_t entry[RECORD_CHECK_BYTES] = {RECORD_CHECK, check.puzzle,
+		check.targets_hit, check.solved, check.path_count,
+		check.beam_hash & 0xff, check.beam_hash >> 8};
+	append(entry, RECORD_CHECK_BYTES);
+}
+
+/* The log so far, padded to an even size for BFile_Write() */
+const uint8_t *record_data(int *size)
+{
+	if (data_used & 1)
+		data[data_used] = RECORD_PAD;
+	*size = (data_used + 1) & ~1;
+	return data;
+}
+
+/* The state a checkpoint compares, with a hash of every beam path */
+void record_state(record_check_t *check)
+{
+	check->puzzle = game_get_puzzle_index();
+	check->targets_hit = get_targets_hit();
+	check->solved = game_is_solved();
+	check->path_count = game_get_path_count();
+	uint16_t hash = 0;
+	for (int i = 0; i < check->path_count; ++i) {
+		path_t *path = game_get_path(i);
+		uint8_t bytes[4] = {path->row, path->col, path->entry,
+			path->exit};
+		for (int j = 0; j < 4; ++j)
+			hash = (hash << 5) + (hash >> 11) + bytes[j];
+	}
+	check->beam_hash = hash;
+}
+
+/* Size of the entry starting with this byte */
+int record_entry_size(const uint8_t *entry)
+{
+	switch (*entry & RECORD_KIND) {
+	case RECORD_GOTO:
+		return 2;
+	case RECORD_CHECK:
+		return RECORD_CHECK_BYTES;
+	default:
+		return 1;
+	}
+}
@@ -0,0 +1,58 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "game.h"
+#include "kbd.h"
+
+#define RECORD_MAGIC "LZR1"
+#define RECORD_BYTES 4096
+#define RECORD_HEAD_BYTES (8 + PUZZLE_MAX)
+
+#define RECORD_TRACE 0x80
+#define RECORD_KIND 0x60
+#define RECORD_DATA 0x1f
+#define RECORD_COMMAND 0x00
+#define RECORD_GOTO 0x20
+#define RECORD_CHECK 0x40
+#define RECORD_PAD 0x60
+#define RECORD_CHECK_BYTES 7
+
+typedef struct {
+	uint8_t puzzle;
+	uint8_t targets_hit;
+	uint8_t solved;
+	uint8_t path_count;
+	uint16_t beam_hash;
+} record_check_t;
+
+void record_start(void);
+void record_stop(void);
+int record_is_on(void);
+int record_is_full(void);
+void record_command(command_t command);
+void record_goto(int i);
+void record_trace(void);
+void record_check(void);
+const uint8_t *record_data(int *size);
+void record_state(record_check_t *check);
+int record_entry_size(const uint8_t *entry);
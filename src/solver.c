@@ -0,0 +1,292 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Finds where to put the movable tokens and how to turn the rotatable ones so
+that a puzzle is solved. The search runs a few steps at a time, so that it
+can share the CPU with the game.
+
+Every token except blocks must be hit, so in a solution, the first movable
+token the beam hits lies on the beam traced without any movable token. Tokens
+are therefore placed one at a time on an empty cell of the current beam:
+the cells the beam crossed before it are then kept empty, since the token
+was the first one hit. Each layout is reached once, and the tokens already
+placed stay hit. Blocks do not stop the beam and are left out until the end.
+Tokens that only rotate are turned before placing anything, and a movable
+laser is placed first, anywhere. Solutions differ in where tokens other than
+blocks go, or in which way they lead the beam.
+*/
+
+#include <string.h>
+#include "solver.h"
+
+#define NONE 0xff
+#define LEVEL_MAX (TOKEN_COUNT + 1)
+
+typedef struct {
+	token_t token;
+	uint8_t cell;
+	uint8_t placed;
+} piece_t;
+
+typedef struct {
+	uint8_t cells[GRID_SIZE];
+	uint8_t cell_count;
+	uint8_t cell_i;
+	uint8_t piece_i;
+	uint8_t dir_i;
+	uint8_t placed;
+	uint8_t laser;
+	uint32_t kept;
+} level_t;
+
+static token_t work[GRID_SIZE];
+static path_t beam[BEAM_MAX];
+static int targets_req;
+static int targets_extra;
+static piece_t pieces[TOKEN_COUNT];
+static int piece_count;
+static piece_t blocks[TOKEN_COUNT];
+static int block_count;
+static uint8_t rotors[TOKEN_COUNT];
+static int rotor_count;
+static level_t levels[LEVEL_MAX];
+static int depth;
+static uint32_t traces;
+static solver_status_t status;
+
+/* Directions that lead the beam differently */
+int solver_dir_count(const token_t *token)
+{
+	if (!token->can_rotate)
+		return 1;
+	switch (token->type) {
+	case TOKEN_LASER:
+	case TOKEN_TARGET:
+		return 4;
+	case TOKEN_CHECKPOINT:
+	case TOKEN_MIRROR:
+	case TOKEN_SPLITTER:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+/* Whether two movable tokens can trade places without changing the puzzle */
+int solver_same_piece(const token_t *a, const token_t *b)
+{
+	return a->type == b->type && a->can_rotate == b->can_rotate &&
+		a->req_target == b->req_target &&
+		(a->can_rotate || a->dir == b->dir);
+}
+
+/*
+Prepares the choices of the node at depth, whose kept cells are set.
+Returns 1 if it is solved.
+*/
+static int enter(void)
+{
+	level_t *level = &levels[depth];
+	uint32_t kept = level->kept;
+	level->cell_count = 0;
+	level->cell_i = 0;
+	level->piece_i = 0;
+	level->dir_i = 0;
+	level->placed = NONE;
+	level->laser = 0;
+	if (depth < rotor_count)
+		return 0;
+
+	trace_t trace;
+	++traces;
+	if (!game_trace(work, targets_extra, beam, &trace)) {
+		// Place the laser first, anywhere
+		level->laser = 1;
+		for (int cell = 0; cell < GRID_SIZE; ++cell)
+			if (work[cell].type == TOKEN_NONE &&
+					!(kept & (1UL << cell)))
+				level->cells[level->cell_count++] = cell;
+		return 0;
+	}
+	if (depth == rotor_count + piece_count)
+		return game_trace_solves(&trace, targets_req);
+
+	// Empty cells on the beam, in the order the beam reaches them
+	uint32_t seen = kept;
+	for (int i = 0; i < trace.path_count; ++i) {
+		int cell = GRID_WIDTH * beam[i].row + beam[i].col;
+		if (work[cell].type != TOKEN_NONE || (seen & (1UL << cell)))
+			continue;
+		seen |= 1UL << cell;
+		level->cells[level->cell_count++] = cell;
+	}
+	return 0;
+}
+
+/* Turns the next rotor, returns 0 once every direction was tried */
+static int next_rotor(level_t *level)
+{
+	token_t *token = &work[rotors[depth]];
+	if (level->dir_i >= solver_dir_count(token))
+		return 0;
+	token->dir = level->dir_i++;
+	return 1;
+}
+
+/* Places a piece on the next cell, returns 0 once every choice was tried */
+static int next_piece(level_t *level)
+{
+	for (; level->cell_i < level->cell_count;
+			++level->cell_i, level->piece_i = 0)
+		for (; level->piece_i < piece_count;
+				++level->piece_i, level->dir_i = 0) {
+			piece_t *piece = &pieces[level->piece_i];
+			if (piece->placed || level->laser !=
+					(piece->token.type == TOKEN_LASER))
+				continue;
+
+			// Identical pieces are tried once
+			int twin = 0;
+			for (int i = 0; i < level->piece_i && !twin; ++i)
+				twin = !pieces[i].placed &&
+					solver_same_piece(&pieces[i].token,
+						&piece->token);
+			int dirs = solver_dir_count(&piece->token);
+			if (twin || level->dir_i >= dirs)
+				continue;
+
+			int cell = level->cells[level->cell_i];
+			work[cell] = piece->token;
+			if (piece->token.can_rotate)
+				work[cell].dir = level->dir_i;
+			++level->dir_i;
+			piece->cell = cell;
+			piece->placed = 1;
+			level->placed = level->piece_i;
+			return 1;
+		}
+	return 0;
+}
+
+/* Cells the beam crossed before the current choice stay empty below it */
+static uint32_t kept_cells(const level_t *level)
+{
+	uint32_t kept = level->kept;
+	if (level->laser)
+		return kept;
+	for (int i = 0; i < level->cell_i; ++i)
+		kept |= 1UL << level->cells[i];
+	return kept;
+}
+
+void solver_start(const token_t grid[GRID_SIZE], int targets)
+{
+	memcpy(work, grid, sizeof(work));
+	targets_req = targets;
+	int req = 0;
+	piece_count = 0;
+	block_count = 0;
+	rotor_count = 0;
+	for (int cell = 0; cell < GRID_SIZE; ++cell) {
+		token_t *token = &work[cell];
+		if (token->type == TOKEN_NONE)
+			continue;
+		if (token->type == TOKEN_TARGET && token->req_target)
+			++req;
+		if (token->can_move) {
+			piece_t *piece = token->type == TOKEN_BLOCK ?
+				&blocks[block_count++] : &pieces[piece_count++];
+			piece->token = *token;
+			piece->cell = cell;
+			piece->placed = 0;
+			token->type = TOKEN_NONE;
+		} else if (token->can_rotate && solver_dir_count(token) > 1) {
+			rotors[rotor_count++] = cell;
+		}
+	}
+	targets_extra = targets_req - req;
+	traces = 0;
+	depth = 0;
+	levels[0].kept = 0;
+	status = enter() ? SOLVER_SOLVED : SOLVER_BUSY;
+}
+
+/* Runs the search for up to steps choices */
+solver_status_t solver_step(int steps)
+{
+	while (status == SOLVER_BUSY && steps-- > 0) {
+		level_t *level = &levels[depth];
+
+		// Take back the last choice of this node
+		if (level->placed != NONE) {
+			piece_t *piece = &pieces[level->placed];
+			work[piece->cell].type = TOKEN_NONE;
+			piece->placed = 0;
+			level->placed = NONE;
+		}
+
+		int more = depth < rotor_count ? next_rotor(level) :
+			next_piece(level);
+		if (!more) {
+			if (!depth)
+				status = SOLVER_UNSOLVABLE;
+			else
+				--depth;
+			continue;
+		}
+		uint32_t kept = kept_cells(level);
+		levels[++depth].kept = kept;
+		if (enter())
+			status = SOLVER_SOLVED;
+	}
+	return status;
+}
+
+/* Goes on looking for another solution after SOLVER_SOLVED */
+void solver_resume(void)
+{
+	if (status == SOLVER_SOLVED)
+		status = SOLVER_BUSY;
+}
+
+solver_status_t solver_status(void)
+{
+	return status;
+}
+
+/* Number of beams traced since solver_start() */
+uint32_t solver_traces(void)
+{
+	return traces;
+}
+
+/* The solved layout, with the movable blocks back on free cells */
+void solver_solution(token_t grid[GRID_SIZE])
+{
+	memcpy(grid, work, sizeof(work));
+	for (int i = 0; i < block_count; ++i) {
+		int cell = blocks[i].cell;
+		for (int n = 0; grid[cell].type != TOKEN_NONE && n < GRID_SIZE;
+				++n)
+			cell = (cell + 1) % GRID_SIZE;
+		grid[cell] = blocks[i].token;
+	}
+}
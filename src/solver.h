@@ -0,0 +1,38 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "game.h"
+
+typedef enum {
+	SOLVER_BUSY,
+	SOLVER_SOLVED,
+	SOLVER_UNSOLVABLE
+} solver_status_t;
+
+int solver_dir_count(const token_t *token);
+int solver_same_piece(const token_t *a, const token_t *b);
+void solver_start(const token_t grid[GRID_SIZE], int targets_req);
+solver_status_t solver_step(int steps);
+void solver_resume(void);
+solver_status_t solver_status(void);
+uint32_t solver_traces(void);
+void solver_solution(token_t grid[GRID_SIZE]);
@@ -0,0 +1,158 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Compressed gray images for screens that are drawn rarely, such as help and
+the logo, so that they take less space in the add-in than fxconv images.
+
+Pixels are coded in rows with the range decoder of range.c. Each pixel has a
+bit for whether it differs from the pixel to its left, in a context of which
+of up, up-left, up-right, left-left and up-up equal that left pixel. A pixel
+that differs then has its level as a 2-bit tree, in a context of the pixel
+above. Pixels outside the image are white. The encoder is
+tools/laser-sprite.py.
+
+Decoded pixels are 2 bits each, 4 to a byte with the leftmost in the top
+bits. Sprites that fit in the cache are decoded once; others are decoded into
+a window of 3 rows and drawn row by row.
+*/
+
+#include <stddef.h>
+#include "range.h"
+#include "sprite.h"
+
+#define WINDOW_ROWS 3
+
+typedef struct {
+	const sprite_t *sprite;
+	uint16_t offset;
+} cached_t;
+
+static uint8_t cache[SPRITE_CACHE_BYTES];
+static cached_t cached[SPRITE_CACHE_MAX];
+static int cached_count;
+static int cache_used;
+
+static int stride(const sprite_t *sprite)
+{
+	return (sprite->width + 3) / 4;
+}
+
+static int get_pixel(const uint8_t *row, int x, int width)
+{
+	if (!row || x < 0 || x >= width)
+		return 0;
+	return (row[x / 4] >> (6 - 2 * (x & 3))) & 3;
+}
+
+static void draw_row(const uint8_t *row, int width, int x, int y,
+	sprite_run_fn run)
+{
+	int start = 0;
+	int level = get_pixel(row, 0, width);
+	for (int i = 1; i <= width; ++i) {
+		int next = get_pixel(row, i, width);
+		if (i == width || next != level) {
+			run(x + start, x + i - 1, y, level);
+			start = i;
+			level = next;
+		}
+	}
+}
+
+/*
+Decodes into rows, which hold the last ring rows decoded. Each row is drawn
+as soon as it is decoded when run is set.
+*/
+static void decode(const sprite_t *sprite, uint8_t *rows, int ring, int x,
+	int y, sprite_run_fn run)
+{
+	range_t rc;
+	uint16_t diff[32];
+	uint16_t level[4][4];
+	int width = sprite->width;
+	int bytes = stride(sprite);
+
+	range_start(&rc, sprite->data, sprite->data + sprite->size);
+	range_probs(diff, 32);
+	range_probs(&level[0][0], 16);
+	for (int r = 0; r < sprite->height; ++r) {
+		uint8_t *row = rows + bytes * (r % ring);
+		const uint8_t *up = r >= 1 ? rows + bytes * ((r - 1) % ring) :
+			NULL;
+		const uint8_t *up2 = r >= 2 ? rows + bytes * ((r - 2) % ring) :
+			NULL;
+		for (int i = 0; i < bytes; ++i)
+			row[i] = 0;
+		for (int c = 0; c < width; ++c) {
+			int left = get_pixel(row, c - 1, width);
+			int ctx = (get_pixel(up, c, width) == left) |
+				(get_pixel(up, c - 1, width) == left) << 1 |
+				(get_pixel(up, c + 1, width) == left) << 2 |
+				(get_pixel(row, c - 2, width) == left) << 3 |
+				(get_pixel(up2, c, width) == left) << 4;
+			int pixel = left;
+			if (range_bit(&rc, &diff[ctx]))
+				pixel = range_tree(&rc,
+					level[get_pixel(up, c, width)], 2);
+			row[c / 4] |= pixel << (6 - 2 * (c & 3));
+		}
+		if (run)
+			draw_row(row, width, x, y + r, run);
+	}
+}
+
+/* The decoded sprite, or NULL if it is too large for the cache */
+static const uint8_t *lookup(const sprite_t *sprite)
+{
+	for (int i = 0; i < cached_count; ++i)
+		if (cached[i].sprite == sprite)
+			return cache + cached[i].offset;
+	int size = stride(sprite) * sprite->height;
+	if (size > SPRITE_CACHE_BYTES)
+		return NULL;
+	// Rarely more than a few sprites are in use, so start over when full
+	if (cached_count == SPRITE_CACHE_MAX ||
+			cache_used + size > SPRITE_CACHE_BYTES) {
+		cached_count = 0;
+		cache_used = 0;
+	}
+	uint8_t *rows = cache + cache_used;
+	decode(sprite, rows, sprite->height, 0, 0, NULL);
+	cached[cached_count].sprite = sprite;
+	cached[cached_count].offset = cache_used;
+	++cached_count;
+	cache_used += size;
+	return rows;
+}
+
+/* Draws a sprite with its top left at (x, y), as runs of one level */
+void sprite_draw(const sprite_t *sprite, int x, int y, sprite_run_fn run)
+{
+	const uint8_t *rows = lookup(sprite);
+	if (!rows) {
+		uint8_t window[WINDOW_ROWS * (SPRITE_WIDTH_MAX / 4)];
+		decode(sprite, window, WINDOW_ROWS, x, y, run);
+		return;
+	}
+	for (int r = 0; r < sprite->height; ++r)
+		draw_row(rows + stride(sprite) * r, sprite->width, x, y + r,
+			run);
+}
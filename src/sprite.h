@@ -0,0 +1,47 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Decoded sprites kept for reuse; larger ones are decoded on every draw
+#define SPRITE_CACHE_BYTES 512
+#define SPRITE_CACHE_MAX 4
+#define SPRITE_WIDTH_MAX 128
+
+typedef struct {
+	uint8_t width;
+	uint8_t height;
+	uint16_t size;
+	const uint8_t *data;
+} sprite_t;
+
+/* Draws pixels x1 to x2 of row y in a gray level, 0 white to 3 black */
+typedef void (*sprite_run_fn)(int x1, int x2, int y, int level);
+
+// Generated from assets/ by tools/laser-sprite.py
+extern const sprite_t sprite_help1;
+extern const sprite_t sprite_help1_cg100;
+extern const sprite_t sprite_help2;
+extern const sprite_t sprite_help2_cg100;
+extern const sprite_t sprite_logo;
+
+void sprite_draw(const sprite_t *sprite, int x, int y, sprite_run_fn run);
@@ -0,0 +1,130 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Frame time breakdown for the debug display. Each measurement adds up the time
+spent between timing_enter() and timing_leave() during a frame.
+timing_frame() stores the totals as one sample and starts the next frame.
+Times are in microseconds, measured by libprof with a hardware timer.
+libprof has no build for gint's fxg3a target, so the G3A build measures
+nothing.
+*/
+
+#ifndef FX9860G_G3A
+#include <libprof.h>
+#endif
+#include "timing.h"
+#include "trace.h"
+
+#ifndef FX9860G_G3A
+static prof_t profs[TIMING_COUNT];
+static uint8_t running[TIMING_COUNT];
+static uint32_t samples[TIMING_COUNT][TIMING_SAMPLES];
+static int sample_i;
+static int sample_count;
+#endif
+
+void timing_init(void)
+{
+#ifndef FX9860G_G3A
+	prof_init();
+	for (int t = 0; t < TIMING_COUNT; ++t)
+		profs[t] = prof_make();
+#endif
+}
+
+void timing_enter(timing_t t)
+{
+#ifndef FX9860G_G3A
+	if (running[t])
+		return;
+	prof_enter(profs[t]);
+	running[t] = 1;
+	TRACE_ADD(t, TRACE_BEGIN);
+#else
+	(void)t;
+#endif
+}
+
+void timing_leave(timing_t t)
+{
+#ifndef FX9860G_G3A
+	if (!running[t])
+		return;
+	prof_leave(profs[t]);
+	running[t] = 0;
+	TRACE_ADD(t, TRACE_END);
+#else
+	(void)t;
+#endif
+}
+
+/* Discards the time measured so far in this frame */
+void timing_reset(timing_t t)
+{
+#ifndef FX9860G_G3A
+	if (running[t])
+		TRACE_ADD(t, TRACE_END);
+	profs[t] = prof_make();
+	running[t] = 0;
+#else
+	(void)t;
+#endif
+}
+
+void timing_frame(void)
+{
+#ifndef FX9860G_G3A
+	for (int t = 0; t < TIMING_COUNT; ++t) {
+		if (running[t])
+			continue;
+		samples[t][sample_i] = prof_time(profs[t]);
+		profs[t] = prof_make();
+	}
+	sample_i = (sample_i + 1) % TIMING_SAMPLES;
+	if (sample_count < TIMING_SAMPLES)
+		++sample_count;
+#endif
+}
+
+/* Minimum, average and maximum over the last TIMING_SAMPLES frames */
+void timing_get(timing_t t, uint32_t *min, uint32_t *avg, uint32_t *max)
+{
+	*min = 0;
+	*avg = 0;
+	*max = 0;
+#ifndef FX9860G_G3A
+	if (!sample_count)
+		return;
+	uint32_t sum = 0;
+	*min = UINT32_MAX;
+	for (int i = 0; i < sample_count; ++i) {
+		uint32_t sample = samples[t][i];
+		sum += sample;
+		if (sample < *min)
+			*min = sample;
+		if (sample > *max)
+			*max = sample;
+	}
+	*avg = sum / sample_count;
+#else
+	(void)t;
+#endif
+}
@@ -0,0 +1,42 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define TIMING_SAMPLES 16
+
+typedef enum {
+	TIMING_KEY,
+	TIMING_LASER,
+	TIMING_BACKGROUND,
+	TIMING_TOKENS,
+	TIMING_BEAM,
+	TIMING_UPDATE,
+	TIMING_COUNT
+} timing_t;
+
+void timing_init(void);
+void timing_enter(timing_t t);
+void timing_leave(timing_t t);
+void timing_reset(timing_t t);
+void timing_frame(void);
+void timing_get(timing_t t, uint32_t *min, uint32_t *avg, uint32_t *max);
@@ -0,0 +1,128 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Event trace, compiled in with "make TRACE=1". Trace points record the time
+an event begins, ends or happens into a ring buffer of the last TRACE_EVENTS
+events, timed by libprof in microseconds.
+
+How to look at a trace:
+1. Run: fxlink -iw | tee trace.txt
+2. Connect the calculator via USB then press EXIT (don't press F1 - F3)
+3. Press "4" in the game
+4. Run: tools/laser-trace.py trace.txt > trace.json
+5. Open trace.json in chrome://tracing or https://ui.perfetto.dev
+
+The dump is sent as fxlink text messages:
+	# laser trace: N events
+	# event NUMBER NAME
+	TIME,EVENT,PHASE
+with TIME in microseconds and PHASE B (begin), E (end) or I (instant).
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "trace.h"
+
+#ifdef TRACE_ON
+#include <libprof.h>
+#include "link.h"
+
+#define DUMP_BYTES 256
+
+typedef struct {
+	uint32_t time;
+	uint8_t event;
+	char phase;
+} entry_t;
+
+static const char *names[TRACE_COUNT] = {"key", "laser", "background",
+	"tokens", "beam", "dupdate", "display_game", "wait", "idle", "file",
+	"gray_on", "gray_off", "dump"};
+
+static entry_t entries[TRACE_EVENTS];
+static int entry_i;
+static int entry_count;
+
+// Time of the last event, and a libprof clock running since then
+static uint32_t now;
+static prof_t since;
+
+void trace_init(void)
+{
+	since = prof_make();
+	prof_enter(since);
+}
+
+/*
+The clock restarts at every event, so that the hardware timer never wraps
+between two events that are less than a few minutes apart.
+*/
+void trace_add(int event, char phase)
+{
+	prof_leave(since);
+	now += prof_time(since);
+	since = prof_make();
+	prof_enter(since);
+
+	entry_t *entry = &entries[entry_i];
+	entry->time = now;
+	entry->event = event;
+	entry->phase = phase;
+	entry_i = (entry_i + 1) % TRACE_EVENTS;
+	if (entry_count < TRACE_EVENTS)
+		++entry_count;
+}
+
+/* Adds a line to the text to send, sending it first if it is full */
+static void append(char *text, const char *line)
+{
+	if (strlen(text) + strlen(line) >= DUMP_BYTES) {
+		link_reply(text);
+		text[0] = 0;
+	}
+	strcat(text, line);
+}
+
+/* Sends the events in the buffer over USB, oldest first */
+void trace_dump(void)
+{
+	trace_add(TRACE_DUMP, TRACE_BEGIN);
+	char text[DUMP_BYTES] = "";
+	char line[48];
+	snprintf(line, sizeof(line), "# laser trace: %i events\n",
+		entry_count);
+	append(text, line);
+	for (int event = 0; event < TRACE_COUNT; ++event) {
+		snprintf(line, sizeof(line), "# event %i %s\n", event,
+			names[event]);
+		append(text, line);
+	}
+	int first = (entry_i - entry_count + TRACE_EVENTS) % TRACE_EVENTS;
+	for (int i = 0; i < entry_count; ++i) {
+		entry_t *entry = &entries[(first + i) % TRACE_EVENTS];
+		snprintf(line, sizeof(line), "%lu,%i,%c\n",
+			(unsigned long)entry->time, entry->event, entry->phase);
+		append(text, line);
+	}
+	link_reply(text);
+	trace_add(TRACE_DUMP, TRACE_END);
+}
+#endif
@@ -0,0 +1,60 @@
+/*
+Laser Logic
+Copyright (C) 2026  Jeffry Johnston
+
+This file is part of Laser Logic.
+
+Laser Logic is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Laser Logic is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "timing.h"
+
+// Build with "make TRACE=1" to record trace points, see trace.c
+#if defined(LASER_TRACE) && !defined(FX9860G_G3A)
+#define TRACE_ON 1
+#endif
+
+#define TRACE_EVENTS 512
+
+#define TRACE_BEGIN 'B'
+#define TRACE_END 'E'
+#define TRACE_INSTANT 'I'
+
+/* Events below TIMING_COUNT are the timing_t measurements */
+typedef enum {
+	TRACE_DISPLAY = TIMING_COUNT,
+	TRACE_WAIT,
+	TRACE_IDLE,
+	TRACE_FILE,
+	TRACE_GRAY_ON,
+	TRACE_GRAY_OFF,
+	TRACE_DUMP,
+	TRACE_COUNT
+} trace_event_t;
+
+#ifdef TRACE_ON
+void trace_init(void);
+void trace_add(int event, char phase);
+void trace_dump(void);
+#define TRACE_INIT() trace_init()
+#define TRACE_ADD(event, phase) trace_add(event, phase)
+#define TRACE_DUMP() trace_dump()
+#else
+#define TRACE_INIT() ((void)0)
+#define TRACE_ADD(event, phase) ((void)0)
+#define TRACE_DUMP() ((void)0)
+#endif
@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+# Laser Logic
+# Copyright (C) 2026  Jeffry Johnston
+#
+# This file is part of Laser Logic.
+#
+# Laser Logic is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Laser Logic is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Render the sprite atlases, assets/beam.png and assets/tokens.png.
+
+  tools/atlas.py [-d assets]
+
+Each atlas is a single row of sprites.
+
+beam.png holds 13x13 glyphs, one for each beam cell box. The glyph order must
+match beam_glyph() in src/display.c:
+    0-24    passing through: 5 * entry + exit (LOC_STOP = 4)
+    25-28   laser emitting: dir
+    29-32   laser entered: entry
+    33-36   target hit: dir, drawn with assets/hit_[nesw].png
+
+tokens.png holds 11x11 tokens with their badge already drawn in: 3 * token +
+badge, where badge is 0 for none, 1 for can_move.png and 2 for can_rotate.png.
+The token order must match token_sprite() in src/display.c and is given by
+TOKENS below.
+"""
+
+import argparse
+import os
+import struct
+import zlib
+
+SIZE = 13
+COUNT = 37
+TOKEN_SIZE = 11
+BADGE_SIZE = 3
+NORTH, EAST, SOUTH, WEST, STOP = range(5)
+
+TRANSPARENT, BLACK, DARK, LIGHT, WHITE = range(5)
+PALETTE = [(0, 0, 0), (0, 0, 0), (85, 85, 85), (170, 170, 170),
+    (255, 255, 255)]
+GRAYS = {(0, 0, 0): BLACK, (85, 85, 85): DARK, (170, 170, 170): LIGHT,
+    (255, 255, 255): WHITE}
+
+ASSETS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+    "assets")
+
+# Token image, badge corner, and whether the badge is inverted
+CORNER_NE = (8, 0)
+CORNER_SE = (8, 8)
+CORNER_SW = (0, 8)
+CORNER_NW = (0, 0)
+TOKENS = [
+    ("token_block", CORNER_NE, True),
+    ("token_checkpoint_ns", CORNER_NE, True),
+    ("token_checkpoint_ew", CORNER_NE, True),
+    ("token_laser_n", CORNER_NE, False),
+    ("token_laser_e", CORNER_NE, False),
+    ("token_laser_s", CORNER_NE, False),
+    ("token_laser_w", CORNER_NE, False),
+    ("token_mirror_nwse", CORNER_NE, False),
+    ("token_mirror_nesw", CORNER_NW, False),
+    ("token_splitter_nwse", CORNER_NE, False),
+    ("token_splitter_nesw", CORNER_NW, False),
+    ("token_target_n", CORNER_SW, False),
+    ("token_target_e", CORNER_NW, False),
+    ("token_target_s", CORNER_NE, False),
+    ("token_target_w", CORNER_SE, False),
+    ("token_target_req_n", CORNER_SW, False),
+    ("token_target_req_e", CORNER_NW, False),
+    ("token_target_req_s", CORNER_NE, False),
+    ("token_target_req_w", CORNER_SE, False),
+]
+BADGES = [None, "can_move", "can_rotate"]
+INVERT = {BLACK: WHITE, DARK: LIGHT, LIGHT: DARK, WHITE: BLACK}
+
+
+def read_png(path):
+    """Read a non-interlaced palette PNG as rows of palette indexes"""
+    data = open(path, "rb").read()
+    pos = 8
+    idat = b""
+    while pos < len(data):
+        size, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + size]
+        pos += 12 + size
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = \
+                struct.unpack(">IIBBBBB", chunk)
+            if color != 3 or interlace:
+                raise ValueError(f"{path}: not a palette PNG")
+        elif kind == b"PLTE":
+            palette = [tuple(chunk[i:i + 3])
+                for i in range(0, len(chunk), 3)]
+        elif kind == b"IDAT":
+            idat += chunk
+    raw = zlib.decompress(idat)
+    stride = (width * depth + 7) // 8
+    rows = []
+    prev = bytes(stride)
+    for y in range(height):
+        line = raw[y * (stride + 1):(y + 1) * (stride + 1)]
+        kind, line = line[0], bytearray(line[1:])
+        for i in range(stride):
+            a = line[i - 1] if i else 0
+            b = prev[i]
+            c = prev[i - 1] if i else 0
+            if kind == 1:
+                line[i] = (line[i] + a) & 0xff
+            elif kind == 2:
+                line[i] = (line[i] + b) & 0xff
+            elif kind == 3:
+                line[i] = (line[i] + (a + b) // 2) & 0xff
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else \
+                    b if pb <= pc else c
+                line[i] = (line[i] + pred) & 0xff
+        prev = bytes(line)
+        bits = "".join(f"{byte:08b}" for byte in line)
+        rows.append([GRAYS[palette[int(bits[x * depth:(x + 1) * depth],
+            2)]] for x in range(width)])
+    return rows
+
+
+def write_png(path, rows):
+    """Write rows of palette indexes as a palette PNG. Atlases without gray
+    or transparent pixels are written as 1-bit black and white, like the
+    images they are made from."""
+    width = len(rows[0])
+    used = set(sum(rows, []))
+
+    def chunk(kind, data):
+        return struct.pack(">I", len(data)) + kind + data + \
+            struct.pack(">I", zlib.crc32(kind + data))
+
+    if used <= {BLACK, WHITE}:
+        depth = 1
+        palette = [PALETTE[BLACK], PALETTE[WHITE]]
+        rows = [[int(pixel == WHITE) for pixel in row] for row in rows]
+    else:
+        depth = 4
+        palette = PALETTE
+    per_byte = 8 // depth
+    raw = b""
+    for row in rows:
+        row = row + [0] * (-width % per_byte)
+        line = bytearray()
+        for i in range(0, len(row), per_byte):
+            byte = 0
+            for pixel in row[i:i + per_byte]:
+                byte = byte << depth | pixel
+            line.append(byte)
+        raw += b"\0" + bytes(line)
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, len(rows),
+            depth, 3, 0, 0, 0)))
+        f.write(chunk(b"PLTE", b"".join(bytes(c) for c in palette)))
+        if depth == 4:
+            f.write(chunk(b"tRNS", b"\0"))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+class Glyph:
+    def __init__(self):
+        self.pixels = [[TRANSPARENT] * SIZE for _ in range(SIZE)]
+
+    def line(self, x1, y1, x2, y2):
+        for y in range(min(y1, y2), max(y1, y2) + 1):
+            for x in range(min(x1, x2), max(x1, x2) + 1):
+                self.pixels[y][x] = LIGHT
+
+    def loc(self, loc):
+        if loc == NORTH:
+            self.line(6, 0, 6, 5)
+        elif loc == EAST:
+            self.line(12, 6, 7, 6)
+        elif loc == SOUTH:
+            self.line(6, 12, 6, 7)
+        elif loc == WEST:
+            self.line(0, 6, 5, 6)
+
+    def image(self, x, y, rows):
+        for dy, row in enumerate(rows):
+            for dx, pixel in enumerate(row):
+                self.pixels[y + dy][x + dx] = pixel
+
+
+def render_beam():
+    """The beam drawing of draw_laser() before it used the atlas"""
+    glyphs = []
+    for entry in range(5):
+        for exit in range(5):
+            glyph = Glyph()
+            glyph.loc(entry)
+            glyph.loc(exit)
+            if not (entry + exit) & 1:
+                glyph.line(6, 6, 6, 6)
+            glyphs.append(glyph)
+    for x1, y1, x2, y2 in ((6, 0, 6, 4), (12, 6, 8, 6), (6, 12, 6, 8),
+            (0, 6, 4, 6)):
+        glyph = Glyph()
+        glyph.line(x1, y1, x2, y2)
+        glyphs.append(glyph)
+    for x1, y1, x2, y2 in ((6, 0, 6, 2), (12, 6, 10, 6), (6, 12, 6, 10),
+            (0, 6, 2, 6)):
+        glyph = Glyph()
+        glyph.line(x1, y1, x2, y2)
+        glyphs.append(glyph)
+    for name, x, y in (("n", 3, 1), ("e", 8, 3), ("s", 3, 8), ("w", 1, 3)):
+        glyph = Glyph()
+        glyph.image(x, y, read_png(os.path.join(ASSETS, f"hit_{name}.png")))
+        glyphs.append(glyph)
+    assert len(glyphs) == COUNT
+    return [sum((glyph.pixels[y] for glyph in glyphs), [])
+        for y in range(SIZE)]
+
+
+def render_tokens():
+    """Each token with each badge, as display_game() used to draw them"""
+    sprites = []
+    for name, (badge_x, badge_y), invert in TOKENS:
+        token = read_png(os.path.join(ASSETS, f"{name}.png"))
+        for badge in BADGES:
+            sprite = [row[:] for row in token]
+            if badge:
+                image = read_png(os.path.join(ASSETS, f"{badge}.png"))
+                for y in range(BADGE_SIZE):
+                    for x in range(BADGE_SIZE):
+                        pixel = image[y][x]
+                        sprite[badge_y + y][badge_x + x] = \
+                            INVERT[pixel] if invert else pixel
+            sprites.append(sprite)
+    return [sum((sprite[y] for sprite in sprites), [])
+        for y in range(TOKEN_SIZE)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("-d", "--directory", default=ASSETS,
+        help="where to write the atlases")
+    args = parser.parse_args()
+    write_png(os.path.join(args.directory, "beam.png"), render_beam())
+    write_png(os.path.join(args.directory, "tokens.png"), render_tokens())
+
+
+if __name__ == "__main__":
+    main()
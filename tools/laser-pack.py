@@ -0,0 +1,318 @@
+#!/usr/bin/env python3
+# Laser Logic
+# Copyright (C) 2026  Jeffry Johnston
+#
+# This file is part of Laser Logic.
+#
+# Laser Logic is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Laser Logic is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Compress a Laser Logic puzzle pack, or expand one back.
+
+  tools/laser-pack.py LASER.dat LASERZ.dat          compress
+  tools/laser-pack.py -d LASERZ.dat LASER.dat       expand
+
+The compressed format is described in src/pack.c. Compressed packs are always
+checked by expanding them again before they are written.
+"""
+
+import argparse
+import sys
+
+MAGIC = b"LZP1"
+HEAD_BYTES = 8
+TITLE_MAX = 23
+GRID_SIZE = 5 * 5
+TOKEN_COUNT = 11
+BYTES_PER_PUZZLE = 2 + 2 * TOKEN_COUNT
+PUZZLE_MAX = 120
+PUZZLE_BYTES = PUZZLE_MAX * BYTES_PER_PUZZLE
+
+PROB_BITS = 11
+PROB_INIT = 1 << (PROB_BITS - 1)
+PROB_MOVE = 5
+RANGE_TOP = 1 << 24
+
+
+class Model:
+    """Probabilities, in the order of model_t in src/pack.c"""
+
+    def __init__(self):
+        self.id = [PROB_INIT]
+        self.targets = [PROB_INIT]
+        self.piece = [PROB_INIT] * TOKEN_COUNT
+        self.data = [PROB_INIT]
+        self.type = [PROB_INIT] * (1 << 3)
+        self.flags = [PROB_INIT] * (1 << 5)
+        self.loc = [PROB_INIT]
+        self.locs = [PROB_INIT] * (1 << 5)
+
+
+class Encoder:
+    def __init__(self):
+        self.low = 0
+        self.range = 0xffffffff
+        self.cache = 0
+        self.cache_size = 1
+        self.out = bytearray()
+
+    def shift_low(self):
+        if self.low < 0xff000000 or self.low >= 1 << 32:
+            carry = self.low >> 32
+            temp = self.cache
+            while True:
+                self.out.append((temp + carry) & 0xff)
+                temp = 0xff
+                self.cache_size -= 1
+                if not self.cache_size:
+                    break
+            self.cache = (self.low >> 24) & 0xff
+        self.cache_size += 1
+        self.low = (self.low & 0x00ffffff) << 8
+
+    def normalize(self):
+        if self.range < RANGE_TOP:
+            self.range = (self.range << 8) & 0xffffffff
+            self.shift_low()
+
+    def bit(self, probs, i, bit):
+        p = probs[i]
+        bound = (self.range >> PROB_BITS) * p
+        if not bit:
+            self.range = bound
+            probs[i] = p + (((1 << PROB_BITS) - p) >> PROB_MOVE)
+        else:
+            self.low += bound
+            self.range -= bound
+            probs[i] = p - (p >> PROB_MOVE)
+        self.normalize()
+
+    def raw(self, value, bits):
+        for i in reversed(range(bits)):
+            self.range >>= 1
+            if (value >> i) & 1:
+                self.low += self.range
+            self.normalize()
+
+    def tree(self, probs, value, bits):
+        m = 1
+        for i in reversed(range(bits)):
+            bit = (value >> i) & 1
+            self.bit(probs, m, bit)
+            m = (m << 1) | bit
+
+    def flush(self):
+        for _ in range(5):
+            self.shift_low()
+        return bytes(self.out)
+
+
+class Decoder:
+    def __init__(self, data, pos):
+        self.data = data
+        self.pos = pos
+        self.range = 0xffffffff
+        self.code = 0
+        for _ in range(5):
+            self.code = (self.code << 8) | self.next_byte()
+
+    def next_byte(self):
+        if self.pos < len(self.data):
+            self.pos += 1
+            return self.data[self.pos - 1]
+        return 0
+
+    def normalize(self):
+        if self.range < RANGE_TOP:
+            self.range = (self.range << 8) & 0xffffffff
+            self.code = ((self.code << 8) | self.next_byte()) & 0xffffffff
+
+    def bit(self, probs, i):
+        p = probs[i]
+        bound = (self.range >> PROB_BITS) * p
+        if self.code < bound:
+            self.range = bound
+            probs[i] = p + (((1 << PROB_BITS) - p) >> PROB_MOVE)
+            bit = 0
+        else:
+            self.range -= bound
+            self.code -= bound
+            probs[i] = p - (p >> PROB_MOVE)
+            bit = 1
+        self.normalize()
+        return bit
+
+    def raw(self, bits):
+        value = 0
+        for _ in range(bits):
+            self.range >>= 1
+            bit = int(self.code >= self.range)
+            if bit:
+                self.code -= self.range
+            value = (value << 1) | bit
+            self.normalize()
+        return value
+
+    def tree(self, probs, bits):
+        m = 1
+        for _ in range(bits):
+            m = (m << 1) | self.bit(probs, m)
+        return m - (1 << bits)
+
+
+def normalized(rec):
+    """Unused pieces are stored as zeroes"""
+    rec = bytearray(rec)
+    for i in range(TOKEN_COUNT):
+        loc, data = rec[2 + 2 * i], rec[3 + 2 * i]
+        if data & 0x07 == 0:
+            rec[2 + 2 * i] = rec[3 + 2 * i] = 0
+        elif loc >= GRID_SIZE:
+            sys.exit("laser-pack: puzzle %i: bad location %i" % (rec[0], loc))
+    return bytes(rec)
+
+
+def encode_block(records):
+    enc = Encoder()
+    model = Model()
+    prev = bytes(BYTES_PER_PUZZLE)
+    for rec in records:
+        if rec[0] == (prev[0] + 1) & 0xff:
+            enc.bit(model.id, 0, 0)
+        else:
+            enc.bit(model.id, 0, 1)
+            enc.raw(rec[0], 8)
+        if rec[1] == prev[1]:
+            enc.bit(model.targets, 0, 0)
+        else:
+            enc.bit(model.targets, 0, 1)
+            enc.raw(rec[1], 8)
+        for i in range(TOKEN_COUNT):
+            loc, data = rec[2 + 2 * i], rec[3 + 2 * i]
+            prev_loc, prev_data = prev[2 + 2 * i], prev[3 + 2 * i]
+            if (loc, data) == (prev_loc, prev_data):
+                enc.bit(model.piece, i, 0)
+                continue
+            enc.bit(model.piece, i, 1)
+            if data == prev_data:
+                enc.bit(model.data, 0, 0)
+            else:
+                enc.bit(model.data, 0, 1)
+                enc.tree(model.type, data & 0x07, 3)
+                enc.tree(model.flags, data >> 3, 5)
+            if data & 0x07:
+                if loc == prev_loc:
+                    enc.bit(model.loc, 0, 0)
+                else:
+                    enc.bit(model.loc, 0, 1)
+                    enc.tree(model.locs, loc, 5)
+        prev = rec
+    return enc.flush()
+
+
+def decode_block(data, pos, count):
+    dec = Decoder(data, pos)
+    model = Model()
+    rec = bytearray(BYTES_PER_PUZZLE)
+    records = []
+    for _ in range(count):
+        if dec.bit(model.id, 0):
+            rec[0] = dec.raw(8)
+        else:
+            rec[0] = (rec[0] + 1) & 0xff
+        if dec.bit(model.targets, 0):
+            rec[1] = dec.raw(8)
+        for i in range(TOKEN_COUNT):
+            if not dec.bit(model.piece, i):
+                continue
+            if dec.bit(model.data, 0):
+                kind = dec.tree(model.type, 3)
+                rec[3 + 2 * i] = (dec.tree(model.flags, 5) << 3) | kind
+            if rec[3 + 2 * i] & 0x07 == 0:
+                rec[2 + 2 * i] = 0
+            elif dec.bit(model.loc, 0):
+                rec[2 + 2 * i] = dec.tree(model.locs, 5)
+        records.append(bytes(rec))
+    return records
+
+
+def split_raw(data):
+    count = min(len(data) // BYTES_PER_PUZZLE, PUZZLE_MAX)
+    records = [data[BYTES_PER_PUZZLE * i:BYTES_PER_PUZZLE * (i + 1)]
+               for i in range(count)]
+    title = data[BYTES_PER_PUZZLE * (len(data) // BYTES_PER_PUZZLE):]
+    return records, title
+
+
+def compress(records, title, per_block):
+    records = [normalized(rec) for rec in records]
+    blocks = [encode_block(records[i:i + per_block])
+              for i in range(0, len(records), per_block)]
+    head = MAGIC + bytes([len(records), len(title), per_block, 0]) + title
+    offset = len(head) + 2 * len(blocks)
+    table = bytearray()
+    for block in blocks:
+        table += offset.to_bytes(2, "big")
+        offset += len(block)
+    return head + table + b"".join(blocks), records
+
+
+def expand(data):
+    if data[:4] != MAGIC:
+        sys.exit("laser-pack: not a compressed pack")
+    count, title_size, per_block = data[4], data[5], data[6]
+    title = data[HEAD_BYTES:HEAD_BYTES + title_size]
+    table = HEAD_BYTES + title_size
+    records = []
+    for block, first in enumerate(range(0, count, per_block)):
+        pos = int.from_bytes(data[table + 2 * block:table + 2 * block + 2],
+                             "big")
+        records += decode_block(data, pos, min(per_block, count - first))
+    return records, title
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input")
+    parser.add_argument("output")
+    parser.add_argument("-d", "--decompress", action="store_true",
+                        help="expand a compressed pack")
+    parser.add_argument("-b", "--block", type=int, default=16,
+                        help="puzzles per block (default: 16)")
+    parser.add_argument("-t", "--title", help="pack title")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if args.decompress:
+        records, title = expand(data)
+        out = b"".join(records) + title
+    else:
+        records, title = split_raw(data)
+        if args.title is not None:
+            title = args.title.encode()
+        if not records or len(title) > TITLE_MAX or not 0 < args.block < 256:
+            sys.exit("laser-pack: nothing to compress, or bad title/block")
+        out, records = compress(records, title, args.block)
+        if len(out) > PUZZLE_BYTES:
+            sys.exit("laser-pack: compressed pack is too large")
+        if expand(out) != (records, title):
+            sys.exit("laser-pack: round trip failed")
+        print("%s: %i puzzles, %i -> %i bytes" % (
+            args.output, len(records), len(data), len(out)))
+    with open(args.output, "wb") as f:
+        f.write(out)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+# Laser Logic
+# Copyright (C) 2026  Jeffry Johnston
+#
+# This file is part of Laser Logic.
+#
+# Laser Logic is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Laser Logic is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Push a puzzle pack to Laser Logic running on a calculator.
+
+The pack is sent as an fxlink message (application "laser", type "pack") and
+replaces the puzzles in RAM; nothing is written to storage memory.
+
+  tools/laser-push.py PACK.dat            send over USB (needs pyusb)
+  tools/laser-push.py --stdout PACK.dat   write the message to stdout, e.g.
+                                          for build_host/laser-link
+"""
+
+import argparse
+import struct
+import sys
+
+FXLINK_VERSION = 0x00000100
+CASIO_VENDOR = 0x07cf
+GINT_PRODUCT = 0x6101
+
+
+def message(data, application=b"laser", type=b"pack"):
+    header = struct.pack("<III16s16s", FXLINK_VERSION, len(data), len(data),
+                         application, type)
+    return header + data
+
+
+def send_usb(msg):
+    import usb.core
+    import usb.util
+
+    dev = usb.core.find(idVendor=CASIO_VENDOR, idProduct=GINT_PRODUCT)
+    if dev is None:
+        sys.exit("laser-push: no calculator found (is the add-in running?)")
+    intf = usb.util.find_descriptor(dev.get_active_configuration(),
+                                    bInterfaceClass=0xff)
+    ep = usb.util.find_descriptor(
+        intf, custom_match=lambda e: usb.util.endpoint_direction(
+            e.bEndpointAddress) == usb.util.ENDPOINT_OUT)
+    if ep is None:
+        sys.exit("laser-push: fxlink interface not found")
+    ep.write(msg)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("pack", nargs="+", help="puzzle pack (LASER*.dat)")
+    parser.add_argument("--stdout", action="store_true",
+                        help="write fxlink messages to stdout")
+    args = parser.parse_args()
+
+    for name in args.pack:
+        with open(name, "rb") as f:
+            msg = message(f.read())
+        if args.stdout:
+            sys.stdout.buffer.write(msg)
+        else:
+            send_usb(msg)
+
+
+if __name__ == "__main__":
+    main()
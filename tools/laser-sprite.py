@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+# Laser Logic
+# Copyright (C) 2026  Jeffry Johnston
+#
+# This file is part of Laser Logic.
+#
+# Laser Logic is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Laser Logic is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Compress images into sprites for the add-in, written as a C source.
+
+  tools/laser-sprite.py -o sprites.c assets/help1.png assets/logo.png ...
+
+Each image becomes a sprite_t named sprite_ and its file name. The format is
+described in src/sprite.c; images must be opaque palette PNGs in the four
+gray levels. Sprites are checked by decoding them again.
+"""
+
+import argparse
+import importlib.util
+import os
+import sys
+
+
+def load_tool(name):
+    """Another script in tools/, whose file name is not a module name"""
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), name)
+    spec = importlib.util.spec_from_file_location(
+        os.path.splitext(name)[0].replace("-", "_"), path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+atlas = load_tool("atlas.py")
+pack = load_tool("laser-pack.py")
+
+WIDTH_MAX = 128
+GRAYS = {atlas.WHITE: 0, atlas.LIGHT: 1, atlas.DARK: 2, atlas.BLACK: 3}
+
+
+class Model:
+    """Probabilities, as in sprite_decode() in src/sprite.c"""
+
+    def __init__(self):
+        self.diff = [pack.PROB_INIT] * 32
+        self.level = [[pack.PROB_INIT] * 4 for _ in range(4)]
+
+
+def pixel(rows, x, y):
+    """Pixels outside the image are white"""
+    if 0 <= y < len(rows) and 0 <= x < len(rows[y]):
+        return rows[y][x]
+    return 0
+
+
+def context(rows, x, y):
+    left = pixel(rows, x - 1, y)
+    return (int(pixel(rows, x, y - 1) == left) |
+        int(pixel(rows, x - 1, y - 1) == left) << 1 |
+        int(pixel(rows, x + 1, y - 1) == left) << 2 |
+        int(pixel(rows, x - 2, y) == left) << 3 |
+        int(pixel(rows, x, y - 2) == left) << 4)
+
+
+def encode(rows):
+    enc = pack.Encoder()
+    model = Model()
+    for y, row in enumerate(rows):
+        for x, level in enumerate(row):
+            left = pixel(rows, x - 1, y)
+            diff = int(level != left)
+            enc.bit(model.diff, context(rows, x, y), diff)
+            if diff:
+                enc.tree(model.level[pixel(rows, x, y - 1)], level, 2)
+    return enc.flush()
+
+
+def decode(data, width, height):
+    dec = pack.Decoder(data, 0)
+    model = Model()
+    rows = []
+    for y in range(height):
+        rows.append([])
+        for x in range(width):
+            level = pixel(rows, x - 1, y)
+            if dec.bit(model.diff, context(rows, x, y)):
+                level = dec.tree(model.level[pixel(rows, x, y - 1)], 2)
+            rows[y].append(level)
+    return rows
+
+
+def read_sprite(path):
+    rows = atlas.read_png(path)
+    if len(rows[0]) > WIDTH_MAX or len(rows) > 255:
+        sys.exit(f"laser-sprite: {path}: too large")
+    try:
+        return [[GRAYS[p] for p in row] for row in rows]
+    except KeyError:
+        sys.exit(f"laser-sprite: {path}: not opaque")
+
+
+def c_source(sprites, paths):
+    out = ["/* Generated by tools/laser-sprite.py from:"]
+    out += [f" * {path}" for path in paths]
+    out += [" */", "", '#include "sprite.h"']
+    for name, rows, data in sprites:
+        out += ["", f"static const uint8_t {name}[] = {{"]
+        for i in range(0, len(data), 12):
+            out.append("\t" + ", ".join(f"0x{b:02x}"
+                for b in data[i:i + 12]) + ",")
+        out += ["};", f"const sprite_t sprite_{name} = "
+            f"{{{len(rows[0])}, {len(rows)}, sizeof({name}), {name}}};"]
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("images", nargs="+")
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    sprites = []
+    for path in args.images:
+        rows = read_sprite(path)
+        data = encode(rows)
+        if decode(data, len(rows[0]), len(rows)) != rows:
+            sys.exit(f"laser-sprite: {path}: round trip failed")
+        name = os.path.splitext(os.path.basename(path))[0]
+        sprites.append((name, rows, data))
+    with open(args.output, "w") as f:
+        f.write(c_source(sprites, args.images))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# Laser Logic
+# Copyright (C) 2026  Jeffry Johnston
+#
+# This file is part of Laser Logic.
+#
+# Laser Logic is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Laser Logic is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with Laser Logic.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Convert a Laser Logic event trace to Chrome trace JSON.
+
+The trace is the fxlink output of a build made with "make TRACE=1", after
+pressing "4" in the game (see src/trace.c). When the output holds several
+dumps, the last one is converted. Open the JSON in chrome://tracing or
+https://ui.perfetto.dev.
+
+  fxlink -iw | tee trace.txt
+  tools/laser-trace.py trace.txt > trace.json
+"""
+
+import argparse
+import json
+import re
+import sys
+
+EVENT_RE = re.compile(r"# event (\d+) (\S+)")
+ENTRY_RE = re.compile(r"(\d+),(\d+),([BEI])")
+
+
+def parse(lines):
+    """Names and (time, event, phase) entries of the last dump."""
+    names, entries = {}, []
+    for line in lines:
+        line = line.strip()
+        if line.startswith("# laser trace:"):
+            names, entries = {}, []
+        elif m := EVENT_RE.fullmatch(line):
+            names[int(m[1])] = m[2]
+        elif m := ENTRY_RE.fullmatch(line):
+            entries.append((int(m[1]), int(m[2]), m[3]))
+    return names, entries
+
+
+def chrome_events(names, entries):
+    """Complete events for each begin/end pair, and instant events.
+
+    An end whose begin fell out of the ring buffer is dropped, and a begin
+    that never ended lasts until the last entry.
+    """
+    events, open_ = [], {}
+
+    def add(name, ts, dur=None):
+        event = {"name": name, "ph": "X" if dur is not None else "i",
+                 "ts": ts, "pid": 1, "tid": 1}
+        if dur is None:
+            event["s"] = "t"
+        else:
+            event["dur"] = dur
+        events.append(event)
+
+    for time, event, phase in entries:
+        name = names.get(event, f"event{event}")
+        if phase == "B":
+            open_.setdefault(event, []).append(time)
+        elif phase == "E":
+            if open_.get(event):
+                start = open_[event].pop()
+                add(name, start, time - start)
+        else:
+            add(name, time)
+    last = entries[-1][0] if entries else 0
+    for event, starts in open_.items():
+        for start in starts:
+            add(names.get(event, f"event{event}"), start, last - start)
+    events.sort(key=lambda e: e["ts"])
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="?", help="fxlink output (default: stdin)")
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, errors="replace") as f:
+            names, entries = parse(f)
+    else:
+        names, entries = parse(sys.stdin)
+    if not entries:
+        sys.exit("laser-trace: no trace found")
+    json.dump({"traceEvents": chrome_events(names, entries),
+               "displayTimeUnit": "ms"}, sys.stdout)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()